@@ -0,0 +1,337 @@
+#include "batch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+/**
+ * @brief 单个工作线程独占的检测器和缓冲区。
+ */
+struct BatchRunner::Worker {
+    explicit Worker(const std::string& eye_cascade_path) : reflection(eye_cascade_path) {}
+
+    ReflectionDetector reflection;
+    EllipseFitter fitter;
+    cv::Mat light, dark, mask;
+    uint64_t steals = 0;
+};
+
+/**
+ * @brief 一个工作线程尚未处理的序号区间 [begin, end)。
+ *
+ * 所有者从头部取任务，窃取者从尾部截走一半，两者都在 mutex 保护下修改。
+ */
+struct BatchRunner::WorkRange {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+/**
+ * @brief 文件名（不含目录和扩展名）为纯数字时返回 true，并输出该数字。
+ */
+static bool numeric_stem(const std::string& path, long& number) {
+    const size_t slash = path.find_last_of("/\\");
+    const size_t start = slash == std::string::npos ? 0 : slash + 1;
+    const size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || dot <= start) {
+        return false;
+    }
+    const std::string stem = path.substr(start, dot - start);
+    if (stem.empty() || stem.size() > 9 ||
+        !std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    number = std::strtol(stem.c_str(), nullptr, 10);
+    return true;
+}
+
+/**
+ * @brief 画面中央一半宽高区域的平均亮度，与 FramePairDemuxer 判断明暗的方式一致。
+ */
+static double center_mean(const cv::Mat& image) {
+    const cv::Rect roi(image.cols / 4, image.rows / 4, image.cols / 2, image.rows / 2);
+    const cv::Scalar mean = cv::mean(roi.empty() ? image : image(roi));
+    double sum = 0.0;
+    for (int c = 0; c < image.channels(); ++c) {
+        sum += mean[c];
+    }
+    return sum / image.channels();
+}
+
+PairOrder resolve_pair_order(const BatchPair& pair, cv::Mat& light_image, cv::Mat& dark_image) {
+    if (pair.ordered) {
+        return PAIR_ORDER_AS_LISTED;
+    }
+    const double difference = center_mean(light_image) - center_mean(dark_image);
+    if (std::abs(difference) < MIN_PAIR_ORDER_DIFFERENCE) {
+        return PAIR_ORDER_AMBIGUOUS;
+    }
+    if (difference < 0) {
+        std::swap(light_image, dark_image);
+        return PAIR_ORDER_SWAPPED;
+    }
+    return PAIR_ORDER_AS_LISTED;
+}
+
+/**
+ * @brief 按文件名编号配对目录中的图像：2k-1 与 2k 为一对，默认 2k 为明瞳，明暗留到处理时判断。
+ */
+static void list_directory_pairs(const std::string& directory, std::vector<BatchPair>& pairs) {
+    std::vector<cv::String> files;
+    cv::glob(directory, files, false);
+
+    std::vector<std::pair<long, std::string>> numbered;
+    for (const cv::String& file : files) {
+        long number = 0;
+        if (numeric_stem(file, number)) {
+            numbered.emplace_back(number, file);
+        }
+    }
+    std::sort(numbered.begin(), numbered.end());
+
+    for (size_t i = 0; i + 1 < numbered.size(); ++i) {
+        const long number = numbered[i].first;
+        if (number % 2 == 1 && numbered[i + 1].first == number + 1) {
+            BatchPair pair;
+            pair.light_path = numbered[i + 1].second;
+            pair.dark_path = numbered[i].second;
+            pair.ordered = false;
+            pairs.push_back(pair);
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief 读取清单文件，每行为“明瞳路径 暗瞳路径”。
+ */
+static bool list_manifest_pairs(const std::string& manifest, std::vector<BatchPair>& pairs) {
+    std::ifstream infile(manifest);
+    if (!infile.is_open()) {
+        std::cerr << "Error: Could not open batch manifest " << manifest << std::endl;
+        return false;
+    }
+
+    const size_t slash = manifest.find_last_of("/\\");
+    const std::string base = slash == std::string::npos ? std::string() : manifest.substr(0, slash + 1);
+    auto resolve = [&base](const std::string& path) {
+        const bool absolute = (!path.empty() && (path[0] == '/' || path[0] == '\\')) ||
+                              (path.size() > 1 && path[1] == ':');
+        return absolute ? path : base + path;
+    };
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(infile, line)) {
+        ++line_number;
+        std::istringstream fields(line);
+        BatchPair pair;
+        if (!(fields >> pair.light_path) || pair.light_path[0] == '#') {
+            continue;
+        }
+        if (!(fields >> pair.dark_path)) {
+            std::cerr << "Warning: Skipping malformed line " << line_number << " in " << manifest << std::endl;
+            continue;
+        }
+        pair.light_path = resolve(pair.light_path);
+        pair.dark_path = resolve(pair.dark_path);
+        pairs.push_back(pair);
+    }
+    return true;
+}
+
+bool list_batch_pairs(const std::string& source, std::vector<BatchPair>& pairs) {
+    pairs.clear();
+    // 能按文件打开的视为清单，否则视为目录
+    std::ifstream probe(source);
+    const bool is_file = probe.is_open() && probe.peek() != std::ifstream::traits_type::eof();
+    probe.close();
+
+    if (is_file) {
+        if (!list_manifest_pairs(source, pairs)) {
+            return false;
+        }
+    } else {
+        list_directory_pairs(source, pairs);
+    }
+    if (pairs.empty()) {
+        std::cerr << "Error: No image pairs found in " << source << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool write_batch_csv(const std::string& output_file, const std::vector<BatchPair>& pairs,
+                     const std::vector<BatchRecord>& records) {
+    std::ofstream outfile(output_file);
+    if (!outfile.is_open()) {
+        std::cerr << "Error: Could not open output file " << output_file << std::endl;
+        return false;
+    }
+
+    outfile << "index,light,dark,order_ambiguous,loaded,pupil_found,pupil_x,pupil_y,pupil_width,pupil_height,pupil_angle,"
+               "pupil_confidence,glint_found,glint_x,glint_y,process_ms\n";
+    const size_t count = std::min(pairs.size(), records.size());
+    for (size_t i = 0; i < count; ++i) {
+        const BatchRecord& record = records[i];
+        const cv::RotatedRect& ellipse = record.pupil.ellipse;
+        const bool pupil = record.pupil.found;
+        const std::string& light = record.swapped ? pairs[i].dark_path : pairs[i].light_path;
+        const std::string& dark = record.swapped ? pairs[i].light_path : pairs[i].dark_path;
+        outfile << i << "," << light << "," << dark << "," << record.order_ambiguous << ","
+                << record.loaded << "," << pupil << ","
+                << record.pupil.center.x << "," << record.pupil.center.y << ","
+                << (pupil ? ellipse.size.width : -1.f) << "," << (pupil ? ellipse.size.height : -1.f) << ","
+                << (pupil ? ellipse.angle : 0.f) << "," << record.pupil.confidence << ","
+                << record.reflection.found << ","
+                << record.reflection.center.x << "," << record.reflection.center.y << ","
+                << record.process_ms << "\n";
+    }
+    return static_cast<bool>(outfile);
+}
+
+BatchRunner::BatchRunner(const BatchConfig& config) : config_(config) {
+    size_t threads = config_.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    config_.threads = threads;
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(new Worker(config_.eye_cascade_path));
+        ranges_.emplace_back(new WorkRange());
+    }
+}
+
+BatchRunner::~BatchRunner() = default;
+
+bool BatchRunner::is_loaded() const {
+    for (const auto& worker : workers_) {
+        if (!worker->reflection.is_loaded()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BatchRunner::run(const std::vector<BatchPair>& pairs, std::vector<BatchRecord>& records) {
+    stats_ = BatchStats();
+    records.assign(pairs.size(), BatchRecord());
+    if (!is_loaded()) {
+        return false;
+    }
+
+    // 按线程数均分出初始区间
+    const size_t threads = workers_.size();
+    for (size_t i = 0; i < threads; ++i) {
+        ranges_[i]->begin = pairs.size() * i / threads;
+        ranges_[i]->end = pairs.size() * (i + 1) / threads;
+        workers_[i]->steals = 0;
+    }
+
+    const int opencv_threads = cv::getNumThreads();
+    cv::setNumThreads(1);
+
+    const int64_t start = cv::getTickCount();
+    std::vector<std::thread> threads_running;
+    threads_running.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        threads_running.emplace_back(&BatchRunner::worker_loop, this, i, std::cref(pairs), std::ref(records));
+    }
+    worker_loop(0, pairs, records);
+    for (auto& thread : threads_running) {
+        thread.join();
+    }
+    stats_.elapsed_sec = (cv::getTickCount() - start) / cv::getTickFrequency();
+
+    cv::setNumThreads(opencv_threads);
+
+    stats_.pairs = static_cast<int64_t>(pairs.size());
+    stats_.threads = threads;
+    for (size_t i = 0; i < threads; ++i) {
+        stats_.steals += workers_[i]->steals;
+    }
+    for (const BatchRecord& record : records) {
+        if (!record.loaded) {
+            ++stats_.failed;
+        }
+    }
+    return true;
+}
+
+void BatchRunner::worker_loop(size_t index, const std::vector<BatchPair>& pairs, std::vector<BatchRecord>& records) {
+    Worker& worker = *workers_[index];
+    WorkRange& own = *ranges_[index];
+    while (true) {
+        size_t next = 0;
+        bool have_task = false;
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.begin < own.end) {
+                next = own.begin++;
+                have_task = true;
+            }
+        }
+        if (have_task) {
+            process_pair(worker, pairs[next], records[next]);
+        } else if (!steal(index)) {
+            break;
+        }
+    }
+}
+
+bool BatchRunner::steal(size_t thief) {
+    const size_t threads = ranges_.size();
+    for (size_t offset = 1; offset < threads; ++offset) {
+        WorkRange& victim = *ranges_[(thief + offset) % threads];
+        size_t begin = 0;
+        size_t end = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            const size_t remaining = victim.end - victim.begin;
+            if (remaining == 0) {
+                continue;
+            }
+            // 至少留一个给所有者，只剩一个时直接拿走
+            const size_t take = remaining == 1 ? 1 : remaining / 2;
+            end = victim.end;
+            victim.end -= take;
+            begin = victim.end;
+        }
+        // 自己的区间已空，其他线程只会缩短它，因此这里可以直接覆盖
+        WorkRange& own = *ranges_[thief];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin;
+            own.end = end;
+        }
+        ++workers_[thief]->steals;
+        return true;
+    }
+    return false;
+}
+
+void BatchRunner::process_pair(Worker& worker, const BatchPair& pair, BatchRecord& record) {
+    const int64_t start = cv::getTickCount();
+    worker.light = cv::imread(pair.light_path);
+    worker.dark = cv::imread(pair.dark_path);
+    if (worker.light.empty() || worker.dark.empty() || worker.light.size() != worker.dark.size()) {
+        std::cerr << "Warning: Could not load image pair " << pair.light_path << " / " << pair.dark_path << std::endl;
+        return;
+    }
+    record.loaded = true;
+    const PairOrder order = resolve_pair_order(pair, worker.light, worker.dark);
+    record.swapped = order == PAIR_ORDER_SWAPPED;
+    record.order_ambiguous = order == PAIR_ORDER_AMBIGUOUS;
+
+    if (compute_pupil_mask(worker.light, worker.dark, worker.mask)) {
+        record.pupil = locate_pupil_in_mask(worker.light, worker.dark, worker.mask, worker.fitter);
+    }
+    // 明瞳图像中的普尔钦斑最清晰
+    record.reflection = worker.reflection.process(worker.light);
+    record.process_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
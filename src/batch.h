@@ -0,0 +1,178 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "detection.h"
+#include "ellipse_fit.h"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BatchPair
+ * @brief 批处理中的一个明暗图像对。
+ */
+struct BatchPair {
+    std::string light_path; ///< 明瞳图像路径
+    std::string dark_path;  ///< 暗瞳图像路径
+    bool ordered = true;    ///< 为 false 时明暗未知，处理时由 resolve_pair_order 按画面中央的平均亮度判断
+};
+
+/**
+ * @struct BatchRecord
+ * @brief 一个图像对的检测结果。
+ */
+struct BatchRecord {
+    bool loaded = false;         ///< 两张图像是否都读取成功且尺寸一致
+    bool swapped = false;        ///< 按亮度判断后，明瞳实际是 BatchPair::dark_path 一项
+    bool order_ambiguous = false; ///< 明暗未知且两张亮度相近，沿用列出的顺序
+    PupilResult pupil;           ///< 瞳孔检测结果
+    ReflectionResult reflection; ///< 光斑检测结果
+    double process_ms = 0.0;     ///< 读图和检测的耗时（毫秒）
+};
+
+/**
+ * @struct BatchConfig
+ * @brief 批处理的配置参数。
+ */
+struct BatchConfig {
+    size_t threads = 0; ///< 工作线程数，0 表示使用全部硬件线程
+    std::string eye_cascade_path = "haarcascades/haarcascade_eye.xml"; ///< 光斑检测使用的 Haar 级联分类器路径
+};
+
+/**
+ * @struct BatchStats
+ * @brief 一次批处理的吞吐量统计。
+ */
+struct BatchStats {
+    int64_t pairs = 0;        ///< 处理的图像对数量
+    int64_t failed = 0;       ///< 读取失败的图像对数量
+    size_t threads = 0;       ///< 实际使用的工作线程数
+    uint64_t steals = 0;      ///< 工作线程从其他线程窃取任务区间的次数
+    double elapsed_sec = 0.0; ///< 总耗时（秒）
+
+    /**
+     * @brief 实测吞吐量（图像对/秒）。
+     */
+    double pairs_per_second() const { return elapsed_sec > 0 ? pairs / elapsed_sec : 0.0; }
+};
+
+/**
+ * @brief 从目录或清单文件得到待处理的图像对列表。
+ *
+ * - source 为目录时，取文件名为纯数字的图像（如 input/1.bmp、input/2.bmp），按数字排序，
+ *   编号 2k-1 与 2k 组成一对，缺少配对的文件被忽略。默认 2k 为明瞳图像（与 main() 中
+ *   input/2.bmp、input/1.bmp 的用法一致），但编号不能保证明暗顺序，因此这些对标记为
+ *   ordered = false，处理时由 resolve_pair_order 判断。
+ * - source 为文件时按清单读取，每行为“明瞳路径 暗瞳路径”，以空白分隔，# 开头的行为注释；
+ *   相对路径相对于清单所在目录。
+ *
+ * @param source 目录或清单文件路径。
+ * @param pairs 输出的图像对列表。
+ * @return 成功读取且至少有一对时返回 true。
+ */
+bool list_batch_pairs(const std::string& source, std::vector<BatchPair>& pairs);
+
+// resolve_pair_order 按亮度决定明暗所需的最小平均亮度差（灰度级）
+const double MIN_PAIR_ORDER_DIFFERENCE = 5.0;
+
+/**
+ * @enum PairOrder
+ * @brief resolve_pair_order 的判断结果。
+ */
+enum PairOrder {
+    PAIR_ORDER_AS_LISTED = 0, ///< 沿用列出的顺序（顺序已知，或亮度明确支持该顺序）
+    PAIR_ORDER_SWAPPED,       ///< 亮度表明列出的暗瞳图像才是明瞳图像，已交换
+    PAIR_ORDER_AMBIGUOUS      ///< 亮度相差不足以判断，沿用列出的顺序
+};
+
+/**
+ * @brief 确定一对已读入图像的明暗顺序，必要时交换 light_image 和 dark_image。
+ *
+ * pair.ordered 为 true 时不做判断。否则与 FramePairDemuxer 一样比较画面中央区域的
+ * 平均亮度，只有两者相差至少 MIN_PAIR_ORDER_DIFFERENCE 个灰度级时才按亮度决定；
+ * 明瞳只在瞳孔处更亮，整体亮度可能几乎相同（如 input/1.bmp 与 2.bmp 只差约 0.4），
+ * 这种情况沿用列出的顺序并返回 PAIR_ORDER_AMBIGUOUS。
+ *
+ * @param pair 图像对（只使用 ordered）。
+ * @param light_image 按列出顺序读入的明瞳图像。
+ * @param dark_image 按列出顺序读入的暗瞳图像。
+ * @return 判断结果。
+ */
+PairOrder resolve_pair_order(const BatchPair& pair, cv::Mat& light_image, cv::Mat& dark_image);
+
+/**
+ * @brief 把批处理结果写成一个 CSV 文件，每个图像对一行，列名见文件首行。
+ *
+ * light、dark 两列为实际采用的明暗顺序，order_ambiguous 为 1 表示明暗未知且亮度无法判断、
+ * 沿用了列出的顺序；未检测到的坐标写为 -1。
+ *
+ * @return 文件写入成功返回 true。
+ */
+bool write_batch_csv(const std::string& output_file, const std::vector<BatchPair>& pairs,
+                     const std::vector<BatchRecord>& records);
+
+/**
+ * @class BatchRunner
+ * @brief 在全部核心上并行处理大量离线明暗图像对。
+ *
+ * 图像对之间没有依赖，每个工作线程持有自己的 ReflectionDetector、EllipseFitter 和
+ * 图像缓冲区，读图、差分、拟合和光斑检测都在同一线程内完成，线程之间只共享任务区间。
+ *
+ * 任务按工作窃取方式分配：开始时每个线程分到一段连续的序号区间，从区间头部逐个取；
+ * 自己的区间取完后，从其他线程区间的尾部窃取剩余的一半。这样读图耗时差异很大时
+ * 各线程也能同时结束，同时每次取任务只锁自己的区间，几乎没有竞争。
+ *
+ * 运行期间把 OpenCV 内部的并行线程数设为 1，避免与工作线程争抢核心。
+ */
+class BatchRunner {
+public:
+    explicit BatchRunner(const BatchConfig& config = BatchConfig());
+    ~BatchRunner();
+
+    /**
+     * @brief 级联分类器是否加载成功。
+     */
+    bool is_loaded() const;
+
+    /**
+     * @brief 处理全部图像对。
+     * @param pairs 图像对列表。
+     * @param records 输出的结果，与 pairs 一一对应。
+     * @return 级联分类器已加载时返回 true。
+     */
+    bool run(const std::vector<BatchPair>& pairs, std::vector<BatchRecord>& records);
+
+    /**
+     * @brief 最近一次 run() 的统计信息。
+     */
+    const BatchStats& stats() const { return stats_; }
+
+private:
+    struct Worker;
+    struct WorkRange;
+
+    /**
+     * @brief 第 index 个工作线程的主循环。
+     */
+    void worker_loop(size_t index, const std::vector<BatchPair>& pairs, std::vector<BatchRecord>& records);
+
+    /**
+     * @brief 从其他线程的区间尾部窃取一半任务放入自己的区间。
+     * @return 窃取到任务时返回 true。
+     */
+    bool steal(size_t thief);
+
+    /**
+     * @brief 读取并处理一个图像对。
+     */
+    static void process_pair(Worker& worker, const BatchPair& pair, BatchRecord& record);
+
+    BatchConfig config_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::unique_ptr<WorkRange>> ranges_;
+    BatchStats stats_;
+};
+
+#endif // BATCH_H
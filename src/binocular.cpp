@@ -0,0 +1,115 @@
+#include "binocular.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+BinocularDetector::BinocularDetector(const std::string& eye_cascade_path) : pool_(1) {
+    for (int i = 0; i < 2; ++i) {
+        eyes_[i].reset(new EyeWorker(eye_cascade_path));
+        tasks_[i] = [this, i] { process_eye(i); };
+    }
+}
+
+bool BinocularDetector::is_loaded() const {
+    return eyes_[0]->reflection.is_loaded() && eyes_[1]->reflection.is_loaded();
+}
+
+BinocularResult BinocularDetector::process(const cv::Mat& light_image, const cv::Mat& dark_image) {
+    if (!prepare(light_image, dark_image) || !is_loaded()) {
+        return BinocularResult();
+    }
+
+    // Haar 检测需要整帧灰度图，转换后两只眼睛的光斑检测也直接取用（只读）
+    if (light_image.channels() == 3) {
+        cv::cvtColor(light_image, gray_, cv::COLOR_BGR2GRAY);
+        glint_source_ = gray_;
+    }
+    const std::vector<cv::Rect>& detected = eyes_[0]->reflection.detect_eyes(glint_source_);
+
+    // 取面积最大的两个区域
+    cv::Rect rois[2];
+    int count = 0;
+    for (const cv::Rect& eye : detected) {
+        if (count < 2) {
+            rois[count++] = eye;
+        } else if (eye.area() > std::min(rois[0].area(), rois[1].area())) {
+            rois[rois[0].area() < rois[1].area() ? 0 : 1] = eye;
+        }
+    }
+    return run_eyes(rois, count);
+}
+
+BinocularResult BinocularDetector::process(const cv::Mat& light_image, const cv::Mat& dark_image,
+                                           const cv::Rect* eye_rois, int count) {
+    if (!prepare(light_image, dark_image)) {
+        return BinocularResult();
+    }
+    return run_eyes(eye_rois, count);
+}
+
+bool BinocularDetector::prepare(const cv::Mat& light_image, const cv::Mat& dark_image) {
+    if (light_image.empty() || dark_image.empty() || light_image.size() != dark_image.size() ||
+        light_image.type() != dark_image.type()) {
+        std::cerr << "Light and dark images must be non-empty and of the same size and type." << std::endl;
+        return false;
+    }
+
+    light_ = light_image;
+    dark_ = dark_image;
+    // 已知眼睛区域时不做整帧灰度转换，光斑检测器各自只转换自己的眼睛区域
+    glint_source_ = light_image;
+    return true;
+}
+
+BinocularResult BinocularDetector::run_eyes(const cv::Rect* eye_rois, int count) {
+    result_ = BinocularResult();
+    result_.eye_count = std::max(0, std::min(count, 2));
+    for (int i = 0; i < result_.eye_count; ++i) {
+        eyes_[i]->roi = eye_rois[i];
+    }
+    // 按图像中从左到右排列
+    if (result_.eye_count == 2 && eyes_[1]->roi.x < eyes_[0]->roi.x) {
+        std::swap(eyes_[0]->roi, eyes_[1]->roi);
+    }
+
+    pool_.run(tasks_, static_cast<size_t>(result_.eye_count));
+
+    light_.release();
+    dark_.release();
+    glint_source_.release();
+    return result_;
+}
+
+void BinocularDetector::process_eye(int index) {
+    EyeWorker& eye = *eyes_[index];
+    EyeObservation& observation = result_.eyes[index];
+    observation.eye_roi = eye.roi & cv::Rect(0, 0, light_.cols, light_.rows);
+    if (observation.eye_roi.width < 3 || observation.eye_roi.height < 3) {
+        return;
+    }
+    const cv::Rect& roi = observation.eye_roi;
+
+    // 瞳孔：只在眼睛区域内差分和拟合，眼睛区域尺寸逐帧变化，差分图像取自工作区
+    eye.workspace.begin_frame();
+    cv::Mat mask;
+    if (compute_pupil_mask(light_(roi), dark_(roi), eye.workspace, mask)) {
+        rank_pupil_candidates(light_(roi), dark_(roi), mask, eye.workspace, cv::Point2f(-1.f, -1.f),
+                              eye.candidates);
+        if (!eye.candidates.empty()) {
+            const PupilCandidate& best = eye.candidates.best();
+            observation.pupil.found = true;
+            observation.pupil.ellipse = best.ellipse;
+            observation.pupil.ellipse.center += cv::Point2f(static_cast<float>(roi.x), static_cast<float>(roi.y));
+            observation.pupil.center = observation.pupil.ellipse.center;
+            observation.pupil.confidence = best.confidence;
+        }
+    }
+
+    // 光斑：彩色输入时检测器只把眼睛区域转换为灰度；级联路径已有整帧灰度图，不再转换
+    observation.reflection = eye.reflection.process(glint_source_, roi);
+
+    if (observation.pupil.found && observation.reflection.found) {
+        observation.vector_valid = true;
+        observation.pupil_glint_vector = observation.pupil.center - observation.reflection.center;
+    }
+}
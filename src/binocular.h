@@ -0,0 +1,113 @@
+#ifndef BINOCULAR_H
+#define BINOCULAR_H
+
+#include "detection.h"
+#include "ellipse_fit.h"
+#include "worker_pool.h"
+#include <opencv2/opencv.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+
+/**
+ * @struct EyeObservation
+ * @brief 单只眼睛在一个明暗帧对上的检测结果，坐标均为整帧坐标。
+ */
+struct EyeObservation {
+    cv::Rect eye_roi;                 ///< 眼睛区域
+    PupilResult pupil;                ///< 瞳孔检测结果
+    ReflectionResult reflection;      ///< 光斑检测结果
+    bool vector_valid = false;        ///< 瞳孔和光斑是否都已找到
+    cv::Point2f pupil_glint_vector;   ///< 瞳孔中心减光斑中心的差向量
+};
+
+/**
+ * @struct BinocularResult
+ * @brief 双眼检测结果。
+ */
+struct BinocularResult {
+    int eye_count = 0;         ///< 参与检测的眼睛数（0、1 或 2）
+    EyeObservation eyes[2];    ///< 按图像中从左到右排列，前 eye_count 项有效
+};
+
+/**
+ * @class BinocularDetector
+ * @brief 双眼并行的瞳孔与光斑检测。
+ *
+ * 整帧只做一次灰度转换和一次 Haar 眼睛检测，取面积最大的两个眼睛区域
+ * （已知眼睛区域时跳过这两步，只转换两个眼睛区域），
+ * 之后两只眼睛的瞳孔检测（区域内差分、二值化、候选评分）和光斑检测
+ * 分别在调用线程和常驻工作线程上同时执行，每只眼睛有独立的拟合器、
+ * 光斑检测器和中间缓冲区，互不共享可写状态。双眼的延迟约等于单眼。
+ *
+ * 实例不能被多个线程同时调用。
+ */
+class BinocularDetector {
+public:
+    /**
+     * @brief 构造检测器，为每只眼睛各加载一份级联分类器并启动一个工作线程。
+     * @param eye_cascade_path Haar 级联分类器 XML 文件路径。
+     */
+    explicit BinocularDetector(const std::string& eye_cascade_path = "haarcascades/haarcascade_eye.xml");
+
+    /**
+     * @brief 级联分类器是否加载成功。
+     */
+    bool is_loaded() const;
+
+    /**
+     * @brief 在整帧上检测眼睛，再并行处理最多两只眼睛。
+     * @param light_image 明瞳图像。
+     * @param dark_image 暗瞳图像，尺寸和类型须与明瞳图像一致。
+     */
+    BinocularResult process(const cv::Mat& light_image, const cv::Mat& dark_image);
+
+    /**
+     * @brief 在已知的眼睛区域内并行检测，跳过级联分类器。
+     * @param light_image 明瞳图像。
+     * @param dark_image 暗瞳图像。
+     * @param eye_rois 眼睛区域数组。
+     * @param count 区域个数，超过 2 时只处理前两个。
+     */
+    BinocularResult process(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Rect* eye_rois, int count);
+
+private:
+    /**
+     * @brief 单只眼睛的检测器和逐帧复用的缓冲区。
+     */
+    struct EyeWorker {
+        explicit EyeWorker(const std::string& eye_cascade_path) : reflection(eye_cascade_path) {}
+
+        ReflectionDetector reflection;
+        PupilWorkspace workspace; // 差分图像、连通域和轮廓缓冲区及椭圆拟合器
+        PupilCandidates candidates;
+        cv::Rect roi; // 本帧要处理的眼睛区域
+    };
+
+    /**
+     * @brief 检查输入并准备本帧的图像头。
+     */
+    bool prepare(const cv::Mat& light_image, const cv::Mat& dark_image);
+
+    /**
+     * @brief 在 eye_rois 的前两个区域上并行执行 process_eye。
+     */
+    BinocularResult run_eyes(const cv::Rect* eye_rois, int count);
+
+    /**
+     * @brief 处理第 index 只眼睛，结果写入 result_.eyes[index]。由线程池调用。
+     */
+    void process_eye(int index);
+
+    std::unique_ptr<EyeWorker> eyes_[2];
+    std::function<void()> tasks_[2];
+    WorkerPool pool_;
+
+    // 本帧的输入和输出，process() 期间由两个任务读取 / 分别写入各自的一项；
+    // glint_source_ 为光斑检测的输入，级联路径下指向整帧灰度图 gray_，否则为明瞳图像
+    cv::Mat light_, dark_, glint_source_;
+    cv::Mat gray_; // 跨帧复用的整帧灰度缓冲区
+    BinocularResult result_;
+};
+
+#endif // BINOCULAR_H
@@ -0,0 +1,155 @@
+#include "blob_label.h"
+#include <algorithm>
+#include <utility>
+
+// 8 邻域链码方向：0 东，1 东北，2 北，3 西北，4 西，5 西南，6 南，7 东南（y 轴向下）
+static const int CHAIN_DX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int CHAIN_DY[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+
+/**
+ * @brief 行程 [start, end]（含两端）的 x 坐标之和与平方和。
+ */
+static void run_sums(int start, int end, int64_t& sum_x, int64_t& sum_x2) {
+    auto square_sum = [](int64_t n) { return n * (n + 1) * (2 * n + 1) / 6; }; // 0^2 + ... + n^2
+    sum_x = (static_cast<int64_t>(start) + end) * (end - start + 1) / 2;
+    sum_x2 = square_sum(end) - (start > 0 ? square_sum(start - 1) : 0);
+}
+
+int BlobLabeler::find_root(int label) {
+    while (parent_[label] != label) {
+        parent_[label] = parent_[parent_[label]];
+        label = parent_[label];
+    }
+    return label;
+}
+
+int BlobLabeler::merge(int a, int b) {
+    a = find_root(a);
+    b = find_root(b);
+    if (a == b) {
+        return a;
+    }
+    // 保留较小的标号：标号按光栅顺序分配，其起点也在前
+    if (b < a) {
+        std::swap(a, b);
+    }
+    parent_[b] = a;
+    BlobStats& dst = stats_[a];
+    const BlobStats& src = stats_[b];
+    dst.area += src.area;
+    dst.m10 += src.m10;
+    dst.m01 += src.m01;
+    dst.m20 += src.m20;
+    dst.m11 += src.m11;
+    dst.m02 += src.m02;
+    dst.min_x = std::min(dst.min_x, src.min_x);
+    dst.min_y = std::min(dst.min_y, src.min_y);
+    dst.max_x = std::max(dst.max_x, src.max_x);
+    dst.max_y = std::max(dst.max_y, src.max_y);
+    return a;
+}
+
+const std::vector<BlobStats>& BlobLabeler::label(const cv::Mat& binary_mask) {
+    prev_runs_.clear();
+    parent_.clear();
+    stats_.clear();
+
+    for (int y = 0; y < binary_mask.rows; ++y) {
+        const uchar* row = binary_mask.ptr<uchar>(y);
+        cur_runs_.clear();
+        size_t prev_index = 0;
+        for (int x = 0; x < binary_mask.cols;) {
+            if (row[x] == 0) {
+                ++x;
+                continue;
+            }
+            Run run{x, x, -1};
+            while (run.end + 1 < binary_mask.cols && row[run.end + 1] != 0) {
+                ++run.end;
+            }
+            x = run.end + 1;
+
+            // 上一行中与 [start - 1, end + 1] 重叠的行程都与本行程连通
+            while (prev_index < prev_runs_.size() && prev_runs_[prev_index].end < run.start - 1) {
+                ++prev_index;
+            }
+            for (size_t i = prev_index; i < prev_runs_.size() && prev_runs_[i].start <= run.end + 1; ++i) {
+                run.label = run.label < 0 ? find_root(prev_runs_[i].label) : merge(run.label, prev_runs_[i].label);
+            }
+            if (run.label < 0) {
+                run.label = static_cast<int>(parent_.size());
+                parent_.push_back(run.label);
+                BlobStats blob;
+                blob.min_x = run.start;
+                blob.max_x = run.end;
+                blob.min_y = blob.max_y = y;
+                blob.start = cv::Point(run.start, y);
+                stats_.push_back(blob);
+            }
+
+            int64_t sum_x, sum_x2;
+            run_sums(run.start, run.end, sum_x, sum_x2);
+            const int64_t length = run.end - run.start + 1;
+            BlobStats& blob = stats_[run.label];
+            blob.area += length;
+            blob.m10 += sum_x;
+            blob.m01 += length * y;
+            blob.m20 += sum_x2;
+            blob.m11 += sum_x * y;
+            blob.m02 += length * y * y;
+            blob.min_x = std::min(blob.min_x, run.start);
+            blob.max_x = std::max(blob.max_x, run.end);
+            blob.max_y = y;
+            cur_runs_.push_back(run);
+        }
+        std::swap(prev_runs_, cur_runs_);
+    }
+
+    blobs_.clear();
+    for (size_t label = 0; label < parent_.size(); ++label) {
+        if (parent_[label] == static_cast<int>(label)) {
+            blobs_.push_back(stats_[label]);
+        }
+    }
+    return blobs_;
+}
+
+void trace_outer_contour(const cv::Mat& binary_mask, const cv::Point& start, const cv::Point& offset,
+                         std::vector<cv::Point>& contour) {
+    contour.clear();
+    auto foreground = [&binary_mask](int x, int y) {
+        return x >= 0 && y >= 0 && x < binary_mask.cols && y < binary_mask.rows && binary_mask.ptr<uchar>(y)[x] != 0;
+    };
+
+    // 起点的西侧是背景；从西侧顺时针寻找第一个前景邻点，它是回到起点前的最后一个轮廓点
+    int s = 4;
+    do {
+        s = (s + 7) & 7;
+    } while (!foreground(start.x + CHAIN_DX[s], start.y + CHAIN_DY[s]) && s != 4);
+    if (!foreground(start.x + CHAIN_DX[s], start.y + CHAIN_DY[s])) {
+        contour.push_back(start + offset); // 孤立像素
+        return;
+    }
+    const cv::Point last(start.x + CHAIN_DX[s], start.y + CHAIN_DY[s]);
+
+    cv::Point current = start;
+    int prev_s = s ^ 4;
+    while (true) {
+        // 从指向上一个点的方向开始逆时针寻找下一个前景点，回到来路之前必然找到
+        do {
+            s = (s + 1) & 7;
+        } while (!foreground(current.x + CHAIN_DX[s], current.y + CHAIN_DY[s]));
+
+        // 只保存链码方向改变处的点（CHAIN_APPROX_SIMPLE）
+        if (s != prev_s) {
+            contour.push_back(current + offset);
+            prev_s = s;
+        }
+        const cv::Point next(current.x + CHAIN_DX[s], current.y + CHAIN_DY[s]);
+        if (next == start && current == last) {
+            break;
+        }
+        current = next;
+        s = (s + 4) & 7;
+    }
+}
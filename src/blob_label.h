@@ -0,0 +1,69 @@
+#ifndef BLOB_LABEL_H
+#define BLOB_LABEL_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct BlobStats
+ * @brief 一个 8 邻域连通域的面积、外接矩形、各阶矩和外轮廓起点。
+ */
+struct BlobStats {
+    int64_t area = 0;
+    int64_t m10 = 0, m01 = 0;
+    int64_t m20 = 0, m11 = 0, m02 = 0;
+    int min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    cv::Point start; ///< 光栅顺序下的第一个像素（最上一行的最左侧），外轮廓跟踪的起点
+
+    cv::Rect bounding_rect() const { return cv::Rect(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1); }
+};
+
+/**
+ * @class BlobLabeler
+ * @brief 单遍行程扫描的 8 邻域连通域标记器。
+ *
+ * 每行先提取前景行程，与上一行的行程比较重叠（8 邻域下允许错开一个像素）并用
+ * 并查集合并；每个行程的矩按等差数列与平方和公式整体累加，不逐像素处理。
+ *
+ * 行程、并查集和结果数组都是成员，只增不减，稳态下逐帧调用不分配堆内存。
+ * 一个实例不能被多个线程同时使用。
+ */
+class BlobLabeler {
+public:
+    /**
+     * @brief 标记二值图像中的连通域并累加统计量。
+     * @param binary_mask 二值图像（CV_8UC1，非零为前景）。
+     * @return 按起点光栅顺序排列的连通域，在下一次调用 label 之前有效。
+     */
+    const std::vector<BlobStats>& label(const cv::Mat& binary_mask);
+
+private:
+    struct Run {
+        int start, end, label;
+    };
+
+    int find_root(int label);
+    int merge(int a, int b);
+
+    std::vector<Run> prev_runs_, cur_runs_;
+    std::vector<int> parent_;
+    std::vector<BlobStats> stats_, blobs_;
+};
+
+/**
+ * @brief 跟踪一个连通域的外轮廓，结果与 cv::findContours(RETR_EXTERNAL, CHAIN_APPROX_SIMPLE)
+ *        对同一连通域给出的点序列相同。
+ *
+ * 按 Suzuki 边界跟踪规则从起点出发，只保存链码方向改变处的点。图像以外视为背景。
+ * 只写入调用方的 contour，容量足够时不分配内存。
+ *
+ * @param binary_mask 二值图像（CV_8UC1，非零为前景）。
+ * @param start 连通域光栅顺序下的第一个像素（BlobStats::start）。
+ * @param offset 加到轮廓坐标上的偏移。
+ * @param contour 输出的轮廓。
+ */
+void trace_outer_contour(const cv::Mat& binary_mask, const cv::Point& start, const cv::Point& offset,
+                         std::vector<cv::Point>& contour);
+
+#endif // BLOB_LABEL_H
@@ -0,0 +1,87 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class BoundedQueue
+ * @brief 有界阻塞队列，用于连接流水线中相邻的两个处理阶段。
+ *
+ * 队列满时 push 阻塞，从而对上游形成反压，保证在途帧数有上限；
+ * close() 之后 push 立即失败，pop 在取完剩余元素后返回 false，
+ * 下游据此得知上游已经结束。
+ *
+ * 元素存放在构造时分配的定长环形数组中（T 须可默认构造），push / pop 只做移动赋值，
+ * 不分配堆内存。
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * @param capacity 队列容量，至少为 1。
+     */
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity), items_(capacity_) {}
+
+    /**
+     * @brief 放入一个元素，队列满时等待。
+     * @return 队列已关闭时返回 false。
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || size_ < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_[(head_ + size_) % capacity_] = std::move(item);
+        ++size_;
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 取出一个元素，队列空时等待。
+     * @return 队列已关闭且为空时返回 false。
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || size_ > 0; });
+        if (size_ == 0) {
+            return false;
+        }
+        item = std::move(items_[head_]);
+        head_ = (head_ + 1) % capacity_;
+        --size_;
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 关闭队列并唤醒所有等待的线程。
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t capacity_;
+    std::vector<T> items_; // 环形数组，有效元素为 [head_, head_ + size_)
+    size_t head_ = 0;
+    size_t size_ = 0;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+#endif // BOUNDED_QUEUE_H
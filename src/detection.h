@@ -1,10 +1,227 @@
 #ifndef DETECTION_H
 #define DETECTION_H
 
+#include "ellipse_fit.h"
+#include "workspace.h"
 #include <opencv2/opencv.hpp>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <fstream>
 
+/**
+ * @struct PupilResult
+ * @brief 单帧瞳孔检测的结果。
+ */
+struct PupilResult {
+    bool found = false;              ///< 是否找到符合条件的瞳孔椭圆
+    cv::Point2f center{-1.f, -1.f};  ///< 瞳孔中心坐标，未找到时为 (-1, -1)
+    cv::RotatedRect ellipse;         ///< 拟合得到的瞳孔椭圆
+    float confidence = 0.f;          ///< 检测置信度，范围 [0, 1]
+};
+
+/**
+ * @struct PupilCandidate
+ * @brief 一个通过面积和形状筛选的瞳孔椭圆候选及其各项评分，评分范围均为 [0, 1]。
+ */
+struct PupilCandidate {
+    cv::RotatedRect ellipse;  ///< 拟合得到的椭圆
+    float confidence = 0.f;   ///< 综合置信度，为下面四项的乘积
+    float fit = 0.f;          ///< 拟合质量：内点比例 / (1 + 内点均方根距离)
+    float circularity = 0.f;  ///< 短长轴之比与轮廓填充率的乘积
+    float contrast = 0.f;     ///< 椭圆内侧与外侧采样的平均明暗瞳灰度差分值之差（/ PUPIL_MASK_THRESHOLD）
+    float proximity = 1.f;    ///< 与上一帧中心的接近程度，没有上一帧时为 1
+};
+
+// PupilCandidates 最多保留的候选个数
+const int MAX_PUPIL_CANDIDATES = 4;
+
+// 差分图像二值化阈值（8 位灰度），也是候选内外对比度的满分差值
+const int PUPIL_MASK_THRESHOLD = 50;
+
+// 瞳孔椭圆筛选的最小和最大面积（像素²），与图像分辨率无关
+const double MIN_ELLIPSE_AREA = 500.0;
+const double MAX_ELLIPSE_AREA = 3000.0;
+
+/**
+ * @struct PupilCandidates
+ * @brief 按置信度从高到低排列的定长候选数组，不分配堆内存。
+ */
+struct PupilCandidates {
+    PupilCandidate items[MAX_PUPIL_CANDIDATES];
+    int count = 0;
+
+    bool empty() const { return count == 0; }
+    const PupilCandidate& best() const { return items[0]; }
+
+    /**
+     * @brief 按置信度插入候选；已满时丢弃置信度最低的一个。
+     * @return 候选被保留时返回 true。
+     */
+    bool insert(const PupilCandidate& candidate) {
+        int position = count;
+        while (position > 0 && items[position - 1].confidence < candidate.confidence) {
+            --position;
+        }
+        if (position >= MAX_PUPIL_CANDIDATES) {
+            return false;
+        }
+        for (int i = std::min(count, MAX_PUPIL_CANDIDATES - 1); i > position; --i) {
+            items[i] = items[i - 1];
+        }
+        items[position] = candidate;
+        count = std::min(count + 1, MAX_PUPIL_CANDIDATES);
+        return true;
+    }
+};
+
+/**
+ * @brief 瞳孔检测的第一阶段：明暗瞳差分、灰度化、高斯模糊与二值化。
+ *
+ * @param light_image 明瞳图像。
+ * @param dark_image 暗瞳图像，尺寸和类型须与明瞳图像一致。
+ * @param binary_mask 输出的二值差分图像。
+ * @return 输入有效时返回 true。
+ */
+bool compute_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat& binary_mask);
+
+/**
+ * @brief 在工作区中计算二值差分图像，不分配堆内存。
+ *
+ * binary_mask 被设为 workspace.arena 中的视图，在下一次 workspace.begin_frame() 之前有效；
+ * 需要跨帧保留时请拷贝。调用方负责在每帧开始时调用 begin_frame()。
+ *
+ * @param light_image 明瞳图像。
+ * @param dark_image 暗瞳图像，尺寸和类型须与明瞳图像一致。
+ * @param workspace 当前线程的工作区。
+ * @param binary_mask 输出的二值差分图像（arena 视图）。
+ * @return 输入有效时返回 true。
+ */
+bool compute_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, PupilWorkspace& workspace,
+                        cv::Mat& binary_mask);
+
+/**
+ * @brief compute_pupil_mask 的单遍融合实现，8 位输入时由 compute_pupil_mask 自动使用。
+ *
+ * 每行只读取一次两帧源图像，差分和灰度化的结果进入 5 行滚动缓冲，纵向、横向
+ * 高斯加权与阈值化后直接写出二值图像，不产生整帧中间结果。各步骤均用向量指令
+ * 实现，整数运算与 absdiff + cvtColor + GaussianBlur(5x5) + threshold(50) 逐像素一致。
+ * 图像按行条带用 cv::parallel_for_ 并行。
+ *
+ * @param light_image 明瞳图像（CV_8UC1 或 CV_8UC3，至少 3x3）。
+ * @param dark_image 暗瞳图像，尺寸和类型与明瞳图像相同。
+ * @param binary_mask 输出的二值图像（CV_8UC1）。
+ */
+void fused_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat& binary_mask);
+
+/**
+ * @brief 同上，各条带的行缓冲取自 workspace.stripe_buffer（只增不减）。
+ *
+ * 上面的重载使用当前线程的默认工作区。
+ */
+void fused_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat& binary_mask,
+                      PupilWorkspace& workspace);
+
+/**
+ * @brief fused_pupil_mask 处理 size 尺寸的图像时所需的条带缓冲字节数。
+ */
+size_t fused_pupil_mask_buffer_size(const cv::Size& size);
+
+/**
+ * @brief 瞳孔检测的第二阶段：在二值差分图像中寻找轮廓并拟合瞳孔椭圆。
+ *
+ * 返回 rank_pupil_candidates（不使用上一帧中心）中置信度最高的候选。
+ * 只有二值图像时没有内外对比度，该项按 1 计，候选只按拟合质量和圆度排序。
+ *
+ * @param binary_mask compute_pupil_mask 输出的二值图像。
+ * @return 瞳孔检测结果。
+ */
+PupilResult locate_pupil_in_mask(const cv::Mat& binary_mask);
+
+/**
+ * @brief 使用指定的椭圆拟合器定位瞳孔，可调整 RANSAC 参数和每帧时间预算。
+ *
+ * 每次调用都会执行 fitter.begin_frame()，即时间预算按帧计算。
+ * 上面的重载使用每个线程各自的默认拟合器（EllipseFitParams 的默认值）。
+ *
+ * @param binary_mask compute_pupil_mask 输出的二值图像。
+ * @param fitter 椭圆拟合器，不能被多个线程同时使用。
+ * @return 瞳孔检测结果。
+ */
+PupilResult locate_pupil_in_mask(const cv::Mat& binary_mask, EllipseFitter& fitter);
+
+/**
+ * @brief 同上，另给出生成 binary_mask 的两帧，候选按包含内外对比度的完整置信度排序。
+ *
+ * 手头有两帧时应使用该重载：只有二值图像时对比度恒为 1，
+ * 与瞳孔大小相近的睫毛、镜框等伪连通域无法被压低。
+ *
+ * @param light_image 生成 binary_mask 的明瞳图像。
+ * @param dark_image 生成 binary_mask 的暗瞳图像。
+ * @param binary_mask compute_pupil_mask 输出的二值图像。
+ * @return 瞳孔检测结果。
+ */
+PupilResult locate_pupil_in_mask(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask);
+
+/**
+ * @brief 同上，使用指定的椭圆拟合器（会执行 begin_frame）。
+ */
+PupilResult locate_pupil_in_mask(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                                 EllipseFitter& fitter);
+
+/**
+ * @brief 对二值差分图像中所有通过筛选的瞳孔椭圆评分并排序。
+ *
+ * 与 locate_pupil_in_mask 的候选来源相同，但不在第一个满足条件的椭圆处停止，
+ * 而是按拟合质量、圆度、内外对比度和与上一帧中心的距离给出综合置信度，
+ * 保留置信度最高的 MAX_PUPIL_CANDIDATES 个。跟踪器可据此在置信度足够高时
+ * 跳过代价较高的备用检测，或直接丢弃不可靠的帧。
+ *
+ * 内外对比度在明暗瞳两帧上按灰度差分值采样（与二值化前的差分图像一致），
+ * 两帧为空时该项按 1 计。
+ *
+ * @param light_image 生成 binary_mask 的明瞳图像（或同一 ROI），可以为空。
+ * @param dark_image 生成 binary_mask 的暗瞳图像，尺寸和类型与明瞳图像相同。
+ * @param binary_mask compute_pupil_mask 输出的二值图像。
+ * @param fitter 椭圆拟合器（会执行 begin_frame）。
+ * @param previous_center 上一帧的瞳孔中心，(-1, -1) 表示没有。
+ * @param ranked 输出的候选，按置信度从高到低排列。
+ */
+void rank_pupil_candidates(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                           EllipseFitter& fitter, const cv::Point2f& previous_center, PupilCandidates& ranked);
+
+/**
+ * @brief 同上，使用 workspace 自带的拟合器，连通域、轮廓等缓冲区也取自 workspace。
+ *
+ * 使用单独拟合器的重载借用当前线程默认工作区的缓冲区。
+ */
+void rank_pupil_candidates(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                           PupilWorkspace& workspace, const cv::Point2f& previous_center, PupilCandidates& ranked);
+
+/**
+ * @brief 使用明暗瞳法在内存中的一对图像上检测瞳孔，不做任何磁盘读写。
+ *
+ * 两帧可以是 BGR 三通道或灰度单通道图像，但尺寸和类型必须一致。
+ *
+ * @param light_image 明瞳图像（红外光与视轴同轴）。
+ * @param dark_image 暗瞳图像（红外光与视轴异轴）。
+ * @return 瞳孔检测结果。
+ */
+PupilResult detect_pupil(const cv::Mat& light_image, const cv::Mat& dark_image);
+
+/**
+ * @brief 使用指定工作区检测瞳孔，开始时调用 workspace.begin_frame()。
+ *
+ * 上面的重载使用当前线程的默认工作区（thread_pupil_workspace）。工作区经过
+ * reserve 或一帧预热后，同一尺寸上限内的逐帧检测不分配堆内存。
+ *
+ * @param light_image 明瞳图像。
+ * @param dark_image 暗瞳图像。
+ * @param workspace 工作区，不能被多个线程同时使用。
+ * @return 瞳孔检测结果。
+ */
+PupilResult detect_pupil(const cv::Mat& light_image, const cv::Mat& dark_image, PupilWorkspace& workspace);
+
 /**
  * @brief 使用明暗瞳法检测瞳孔中心。
  *
@@ -14,6 +231,94 @@
  */
 void detect_pupil(const std::string& light_image_path, const std::string& dark_image_path, const std::string& output_file);
 
+/**
+ * @struct ReflectionResult
+ * @brief 单帧普尔钦斑检测的结果。
+ */
+struct ReflectionResult {
+    bool eye_found = false;          ///< 是否得到了眼睛区域
+    bool found = false;              ///< 是否找到反射光斑
+    cv::Rect eye_roi;                ///< 所使用的眼睛区域（原图坐标）
+    cv::Point2f center{-1.f, -1.f};  ///< 光斑中心（原图坐标），未找到时为 (-1, -1)
+};
+
+/**
+ * @class ReflectionDetector
+ * @brief 可复用的普尔钦斑检测器。
+ *
+ * 构造时只加载一次 Haar 级联分类器，并持有逐帧复用的中间缓冲区，
+ * 因此每帧的开销只取决于像素处理本身。一个实例不能被多个线程同时调用，
+ * 多线程场景请为每个线程创建独立实例。
+ */
+class ReflectionDetector {
+public:
+    /**
+     * @brief 构造检测器并加载眼睛级联分类器。
+     * @param eye_cascade_path Haar 级联分类器 XML 文件路径。
+     */
+    explicit ReflectionDetector(const std::string& eye_cascade_path = "haarcascades/haarcascade_eye.xml");
+
+    /**
+     * @brief 级联分类器是否加载成功。
+     */
+    bool is_loaded() const { return loaded_; }
+
+    /**
+     * @brief 处理一帧图像：先用级联分类器定位眼睛，再在第一个眼睛区域内检测光斑。
+     * @param image BGR 或灰度图像。
+     * @return 光斑检测结果。
+     */
+    ReflectionResult process(const cv::Mat& image);
+
+    /**
+     * @brief 在已知的眼睛区域内检测光斑，跳过级联分类器；只对眼睛区域做灰度转换。
+     * @param image BGR 或灰度图像。
+     * @param eye_roi 眼睛区域（原图坐标），会被裁剪到图像范围内。
+     * @return 光斑检测结果。
+     */
+    ReflectionResult process(const cv::Mat& image, const cv::Rect& eye_roi);
+
+    /**
+     * @brief 只运行级联分类器，返回检测到的全部眼睛区域（原图坐标）。
+     * @param image BGR 或灰度图像。
+     * @return 眼睛区域，在下一次调用 process / detect_eyes 之前有效。
+     */
+    const std::vector<cv::Rect>& detect_eyes(const cv::Mat& image);
+
+private:
+    /**
+     * @brief 将输入转换为灰度图，结果存放在 gray_ 中（灰度输入不拷贝）。
+     */
+    const cv::Mat& to_gray(const cv::Mat& image);
+
+    /**
+     * @brief 在灰度图上运行级联分类器，结果存放在 eyes_ 中。
+     */
+    void detect_eyes_gray(const cv::Mat& gray);
+
+    /**
+     * @brief 在眼睛区域的灰度图像内检测光斑，中间结果取自 arena_（调用前由调用方重置）。
+     * @param gray 眼睛区域的灰度图像。
+     * @param eye_roi 该区域在原图中的位置（已裁剪到图像范围内）。
+     */
+    ReflectionResult find_in_roi(const cv::Mat& gray, const cv::Rect& eye_roi);
+
+    /**
+     * @brief 跟踪二值图像中每个连通域的外轮廓，返回面积最大的轮廓的质心加上 offset；没有时返回 (-1, -1)。
+     */
+    cv::Point2f largest_contour_center(const cv::Mat& binary, const cv::Point& offset);
+
+    cv::CascadeClassifier eye_cascade_;
+    bool loaded_ = false;
+
+    // 逐帧复用的中间缓冲区；眼睛区域尺寸逐帧变化，区域内的灰度、模糊和二值图像取自 arena_
+    cv::Mat gray_;
+    FrameArena arena_;
+    BlobLabeler labeler_;
+    std::vector<cv::Rect> eyes_;
+    std::vector<cv::Point> contour_, largest_contour_;
+};
+
 /**
  * @brief 检测眼睛图像中的普尔钦斑（角膜反射光斑）中心。
  *
@@ -0,0 +1,504 @@
+#include "ellipse_fit.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// 矩累加时每隔多少个点把单精度向量累加器归约到双精度，限制单精度累加的舍入误差
+static const int MOMENT_BLOCK = 256;
+
+// 直接拟合和 RANSAC 每次采样所需的点数
+static const int SAMPLE_SIZE = 6;
+
+// RANSAC 自适应迭代次数对应的置信度
+static const double RANSAC_CONFIDENCE = 0.99;
+
+/**
+ * @brief 累加归一化坐标的矩 m[i][j] = sum(x^i y^j)，i + j <= 4。
+ */
+static void accumulate_moments(const float* xs, const float* ys, int n, double m[5][5]) {
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            m[i][j] = 0.0;
+        }
+    }
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    while (i <= n - lanes) {
+        cv::v_float32 s10 = cv::vx_setzero_f32(), s01 = cv::vx_setzero_f32();
+        cv::v_float32 s20 = cv::vx_setzero_f32(), s11 = cv::vx_setzero_f32(), s02 = cv::vx_setzero_f32();
+        cv::v_float32 s30 = cv::vx_setzero_f32(), s21 = cv::vx_setzero_f32();
+        cv::v_float32 s12 = cv::vx_setzero_f32(), s03 = cv::vx_setzero_f32();
+        cv::v_float32 s40 = cv::vx_setzero_f32(), s31 = cv::vx_setzero_f32(), s22 = cv::vx_setzero_f32();
+        cv::v_float32 s13 = cv::vx_setzero_f32(), s04 = cv::vx_setzero_f32();
+        const int block_end = std::min(n, i + MOMENT_BLOCK);
+        for (; i <= block_end - lanes; i += lanes) {
+            const cv::v_float32 x = cv::vx_load(xs + i);
+            const cv::v_float32 y = cv::vx_load(ys + i);
+            const cv::v_float32 xx = cv::v_mul(x, x);
+            const cv::v_float32 xy = cv::v_mul(x, y);
+            const cv::v_float32 yy = cv::v_mul(y, y);
+            s10 = cv::v_add(s10, x);
+            s01 = cv::v_add(s01, y);
+            s20 = cv::v_add(s20, xx);
+            s11 = cv::v_add(s11, xy);
+            s02 = cv::v_add(s02, yy);
+            s30 = cv::v_fma(xx, x, s30);
+            s21 = cv::v_fma(xx, y, s21);
+            s12 = cv::v_fma(xy, y, s12);
+            s03 = cv::v_fma(yy, y, s03);
+            s40 = cv::v_fma(xx, xx, s40);
+            s31 = cv::v_fma(xx, xy, s31);
+            s22 = cv::v_fma(xx, yy, s22);
+            s13 = cv::v_fma(xy, yy, s13);
+            s04 = cv::v_fma(yy, yy, s04);
+        }
+        m[1][0] += cv::v_reduce_sum(s10);
+        m[0][1] += cv::v_reduce_sum(s01);
+        m[2][0] += cv::v_reduce_sum(s20);
+        m[1][1] += cv::v_reduce_sum(s11);
+        m[0][2] += cv::v_reduce_sum(s02);
+        m[3][0] += cv::v_reduce_sum(s30);
+        m[2][1] += cv::v_reduce_sum(s21);
+        m[1][2] += cv::v_reduce_sum(s12);
+        m[0][3] += cv::v_reduce_sum(s03);
+        m[4][0] += cv::v_reduce_sum(s40);
+        m[3][1] += cv::v_reduce_sum(s31);
+        m[2][2] += cv::v_reduce_sum(s22);
+        m[1][3] += cv::v_reduce_sum(s13);
+        m[0][4] += cv::v_reduce_sum(s04);
+    }
+#endif
+    for (; i < n; ++i) {
+        const double x = xs[i], y = ys[i];
+        const double xx = x * x, xy = x * y, yy = y * y;
+        m[1][0] += x;
+        m[0][1] += y;
+        m[2][0] += xx;
+        m[1][1] += xy;
+        m[0][2] += yy;
+        m[3][0] += xx * x;
+        m[2][1] += xx * y;
+        m[1][2] += xy * y;
+        m[0][3] += yy * y;
+        m[4][0] += xx * xx;
+        m[3][1] += xx * xy;
+        m[2][2] += xx * yy;
+        m[1][3] += xy * yy;
+        m[0][4] += yy * yy;
+    }
+    m[0][0] = n;
+}
+
+/**
+ * @brief 3x3 矩阵求逆，矩阵接近奇异（点共线等退化情况）时返回 false。
+ */
+static bool invert3(const double a[3][3], double inv[3][3]) {
+    const double c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+    const double c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+    const double c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+    const double det = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+    double scale = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            scale = std::max(scale, std::abs(a[i][j]));
+        }
+    }
+    if (!(std::abs(det) > 1e-12 * scale * scale * scale)) {
+        return false;
+    }
+    const double r = 1.0 / det;
+    inv[0][0] = c00 * r;
+    inv[1][0] = c01 * r;
+    inv[2][0] = c02 * r;
+    inv[0][1] = (a[0][2] * a[2][1] - a[0][1] * a[2][2]) * r;
+    inv[1][1] = (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * r;
+    inv[2][1] = (a[0][1] * a[2][0] - a[0][0] * a[2][1]) * r;
+    inv[0][2] = (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * r;
+    inv[1][2] = (a[0][2] * a[1][0] - a[0][0] * a[1][2]) * r;
+    inv[2][2] = (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * r;
+    return true;
+}
+
+/**
+ * @brief 求 t^3 + a t^2 + b t + c = 0 的实根，返回实根个数（1 或 3）。
+ */
+static int solve_cubic(double a, double b, double c, double roots[3]) {
+    const double p = b - a * a / 3.0;
+    const double q = 2.0 * a * a * a / 27.0 - a * b / 3.0 + c;
+    const double shift = -a / 3.0;
+    const double disc = q * q / 4.0 + p * p * p / 27.0;
+    if (disc > 0.0 || p >= 0.0) {
+        const double s = std::sqrt(std::max(0.0, disc));
+        roots[0] = std::cbrt(-q / 2.0 + s) + std::cbrt(-q / 2.0 - s) + shift;
+        return 1;
+    }
+    const double r = 2.0 * std::sqrt(-p / 3.0);
+    const double phi = std::acos(std::max(-1.0, std::min(1.0, 3.0 * q / (p * r))));
+    for (int k = 0; k < 3; ++k) {
+        roots[k] = r * std::cos(phi / 3.0 - 2.0 * CV_PI * k / 3.0) + shift;
+    }
+    return 3;
+}
+
+/**
+ * @brief 由矩做直接最小二乘椭圆拟合（Halir & Flusser, 1998），
+ * 输出二次曲线 A x^2 + B xy + C y^2 + D x + E y + F = 0 的系数。
+ */
+static bool conic_from_moments(const double m[5][5], double conic[6]) {
+    // 设计矩阵 D1 = [x^2, xy, y^2]，D2 = [x, y, 1]；S1 = D1'D1，S2 = D1'D2，S3 = D2'D2
+    const double s1[3][3] = {
+        {m[4][0], m[3][1], m[2][2]},
+        {m[3][1], m[2][2], m[1][3]},
+        {m[2][2], m[1][3], m[0][4]},
+    };
+    const double s2[3][3] = {
+        {m[3][0], m[2][1], m[2][0]},
+        {m[2][1], m[1][2], m[1][1]},
+        {m[1][2], m[0][3], m[0][2]},
+    };
+    const double s3[3][3] = {
+        {m[2][0], m[1][1], m[1][0]},
+        {m[1][1], m[0][2], m[0][1]},
+        {m[1][0], m[0][1], m[0][0]},
+    };
+    double s3_inv[3][3];
+    if (!invert3(s3, s3_inv)) {
+        return false;
+    }
+
+    // 线性部分 a2 = T a1，T = -S3^-1 S2'；约化散布矩阵 M = S1 + S2 T
+    double t[3][3], reduced[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            t[i][j] = -(s3_inv[i][0] * s2[j][0] + s3_inv[i][1] * s2[j][1] + s3_inv[i][2] * s2[j][2]);
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            reduced[i][j] = s1[i][j] + s2[i][0] * t[0][j] + s2[i][1] * t[1][j] + s2[i][2] * t[2][j];
+        }
+    }
+
+    // 左乘约束矩阵 C1 = [0 0 2; 0 -1 0; 2 0 0] 的逆
+    double mat[3][3];
+    for (int j = 0; j < 3; ++j) {
+        mat[0][j] = reduced[2][j] / 2.0;
+        mat[1][j] = -reduced[1][j];
+        mat[2][j] = reduced[0][j] / 2.0;
+    }
+
+    // 特征多项式 λ^3 - tr λ^2 + (主子式之和) λ - det = 0
+    const double trace = mat[0][0] + mat[1][1] + mat[2][2];
+    const double minors = mat[0][0] * mat[1][1] - mat[0][1] * mat[1][0] +
+                          mat[0][0] * mat[2][2] - mat[0][2] * mat[2][0] +
+                          mat[1][1] * mat[2][2] - mat[1][2] * mat[2][1];
+    const double det = mat[0][0] * (mat[1][1] * mat[2][2] - mat[1][2] * mat[2][1]) -
+                       mat[0][1] * (mat[1][0] * mat[2][2] - mat[1][2] * mat[2][0]) +
+                       mat[0][2] * (mat[1][0] * mat[2][1] - mat[1][1] * mat[2][0]);
+    double lambdas[3];
+    const int root_count = solve_cubic(-trace, minors, -det, lambdas);
+
+    // 取满足椭圆约束 4AC - B^2 > 0 的特征向量
+    double best_constraint = 0.0;
+    double a1[3] = {0.0, 0.0, 0.0};
+    for (int k = 0; k < root_count; ++k) {
+        double rows[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                rows[i][j] = mat[i][j] - (i == j ? lambdas[k] : 0.0);
+            }
+        }
+        // 零空间向量取两行叉积中模最大者
+        double v[3] = {0.0, 0.0, 0.0};
+        double v_norm = 0.0;
+        for (int r0 = 0; r0 < 3; ++r0) {
+            const int r1 = (r0 + 1) % 3;
+            const double c[3] = {
+                rows[r0][1] * rows[r1][2] - rows[r0][2] * rows[r1][1],
+                rows[r0][2] * rows[r1][0] - rows[r0][0] * rows[r1][2],
+                rows[r0][0] * rows[r1][1] - rows[r0][1] * rows[r1][0],
+            };
+            const double c_norm = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+            if (c_norm > v_norm) {
+                v_norm = c_norm;
+                std::copy(c, c + 3, v);
+            }
+        }
+        if (v_norm <= 0.0) {
+            continue;
+        }
+        const double constraint = (4.0 * v[0] * v[2] - v[1] * v[1]) / v_norm;
+        if (constraint > best_constraint) {
+            best_constraint = constraint;
+            std::copy(v, v + 3, a1);
+        }
+    }
+    if (best_constraint <= 0.0) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        conic[i] = a1[i];
+        conic[3 + i] = t[i][0] * a1[0] + t[i][1] * a1[1] + t[i][2] * a1[2];
+    }
+    return true;
+}
+
+/**
+ * @brief 二次曲线系数转换为椭圆的中心、轴长和角度（与 conic 相同的坐标系）。
+ */
+static bool conic_to_ellipse(const double conic[6], cv::Point2d& center, double& width, double& height, double& angle) {
+    const double sign = conic[0] + conic[2] < 0 ? -1.0 : 1.0;
+    const double a = sign * conic[0], b = sign * conic[1], c = sign * conic[2];
+    const double d = sign * conic[3], e = sign * conic[4], f = sign * conic[5];
+    const double den = b * b - 4.0 * a * c;
+    if (!(den < 0.0)) {
+        return false;
+    }
+    center.x = (2.0 * c * d - b * e) / den;
+    center.y = (2.0 * a * e - b * d) / den;
+    const double f0 = f + (d * center.x + e * center.y) / 2.0; // 中心处的函数值
+    const double r = std::sqrt((a - c) * (a - c) + b * b);
+    const double lambda_u = (a + c + r) / 2.0; // angle 方向上的二次项系数
+    const double lambda_v = (a + c - r) / 2.0;
+    if (!(f0 < 0.0) || !(lambda_v > 0.0)) {
+        return false;
+    }
+    width = 2.0 * std::sqrt(-f0 / lambda_u);
+    height = 2.0 * std::sqrt(-f0 / lambda_v);
+    angle = 0.5 * std::atan2(b, a - c) * 180.0 / CV_PI;
+    if (angle < 0.0) {
+        angle += 180.0;
+    }
+    return true;
+}
+
+/**
+ * @brief 把点平移到质心并缩放到均方根距离为 sqrt(2)，以 SoA 形式写入 xs/ys。
+ */
+template <typename PointT>
+static bool load_normalized(const std::vector<PointT>& points, std::vector<float>& xs, std::vector<float>& ys,
+                            double& mean_x, double& mean_y, double& scale) {
+    const size_t n = points.size();
+    mean_x = 0.0;
+    mean_y = 0.0;
+    for (const PointT& p : points) {
+        mean_x += p.x;
+        mean_y += p.y;
+    }
+    mean_x /= n;
+    mean_y /= n;
+    double spread = 0.0;
+    for (const PointT& p : points) {
+        spread += (p.x - mean_x) * (p.x - mean_x) + (p.y - mean_y) * (p.y - mean_y);
+    }
+    if (!(spread > 0.0)) {
+        return false;
+    }
+    scale = std::sqrt(2.0 * n / spread);
+
+    xs.resize(n);
+    ys.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        xs[i] = static_cast<float>((points[i].x - mean_x) * scale);
+        ys[i] = static_cast<float>((points[i].y - mean_y) * scale);
+    }
+    return true;
+}
+
+EllipseFitter::EllipseFitter(const EllipseFitParams& params) : params_(params), rng_(params.seed) {}
+
+void EllipseFitter::begin_frame() {
+    frame_deadline_ = 0;
+    if (params_.frame_budget_ms > 0) {
+        frame_deadline_ = cv::getTickCount() +
+                          static_cast<int64_t>(params_.frame_budget_ms * cv::getTickFrequency() / 1000.0);
+    }
+}
+
+bool EllipseFitter::budget_exhausted() const {
+    return frame_deadline_ != 0 && cv::getTickCount() > frame_deadline_;
+}
+
+bool EllipseFitter::fit(const std::vector<cv::Point>& contour, EllipseFit& result) {
+    result = EllipseFit();
+    result.points = static_cast<int>(contour.size());
+    if (contour.size() < static_cast<size_t>(SAMPLE_SIZE) ||
+        !load_normalized(contour, xs_, ys_, mean_x_, mean_y_, scale_)) {
+        return false;
+    }
+    return fit_normalized(result);
+}
+
+bool EllipseFitter::fit(const std::vector<cv::Point2f>& points, EllipseFit& result) {
+    result = EllipseFit();
+    result.points = static_cast<int>(points.size());
+    if (points.size() < static_cast<size_t>(SAMPLE_SIZE) ||
+        !load_normalized(points, xs_, ys_, mean_x_, mean_y_, scale_)) {
+        return false;
+    }
+    return fit_normalized(result);
+}
+
+int EllipseFitter::count_inliers(const double conic[6], float threshold, uint8_t* inliers, double* sum_squared) const {
+    const int n = static_cast<int>(xs_.size());
+    const float a = static_cast<float>(conic[0]), b = static_cast<float>(conic[1]), c = static_cast<float>(conic[2]);
+    const float d = static_cast<float>(conic[3]), e = static_cast<float>(conic[4]), f = static_cast<float>(conic[5]);
+    const float threshold2 = threshold * threshold;
+    int count = 0;
+    double squared = 0.0;
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    // 只需计数时向量化；需要逐点标记时走下面的标量循环
+    if (inliers == nullptr) {
+        const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 va = cv::vx_setall_f32(a), vb = cv::vx_setall_f32(b), vc = cv::vx_setall_f32(c);
+        const cv::v_float32 vd = cv::vx_setall_f32(d), ve = cv::vx_setall_f32(e), vf = cv::vx_setall_f32(f);
+        const cv::v_float32 va2 = cv::vx_setall_f32(2 * a), vc2 = cv::vx_setall_f32(2 * c);
+        const cv::v_float32 vt2 = cv::vx_setall_f32(threshold2);
+        const cv::v_float32 one = cv::vx_setall_f32(1.f), zero = cv::vx_setzero_f32();
+        const cv::v_float32 tiny = cv::vx_setall_f32(FLT_MIN);
+        cv::v_float32 counts = cv::vx_setzero_f32(), sums = cv::vx_setzero_f32();
+        for (; i <= n - lanes; i += lanes) {
+            const cv::v_float32 x = cv::vx_load(xs_.data() + i);
+            const cv::v_float32 y = cv::vx_load(ys_.data() + i);
+            // Q = (A x + B y + D) x + (C y + E) y + F，梯度 (2A x + B y + D, B x + 2C y + E)
+            const cv::v_float32 ax_by_d = cv::v_fma(va, x, cv::v_fma(vb, y, vd));
+            const cv::v_float32 q = cv::v_fma(ax_by_d, x, cv::v_fma(cv::v_fma(vc, y, ve), y, vf));
+            const cv::v_float32 gx = cv::v_fma(va2, x, cv::v_fma(vb, y, vd));
+            const cv::v_float32 gy = cv::v_fma(vb, x, cv::v_fma(vc2, y, ve));
+            const cv::v_float32 q2 = cv::v_mul(q, q);
+            const cv::v_float32 g2 = cv::v_max(cv::v_fma(gx, gx, cv::v_mul(gy, gy)), tiny);
+            const cv::v_float32 mask = cv::v_ge(cv::v_mul(vt2, g2), q2);
+            counts = cv::v_add(counts, cv::v_select(mask, one, zero));
+            sums = cv::v_add(sums, cv::v_select(mask, cv::v_div(q2, g2), zero));
+        }
+        count = static_cast<int>(cv::v_reduce_sum(counts));
+        squared = cv::v_reduce_sum(sums);
+    }
+#endif
+    for (; i < n; ++i) {
+        const float x = xs_[i], y = ys_[i];
+        const float q = (a * x + b * y + d) * x + (c * y + e) * y + f;
+        const float gx = 2 * a * x + b * y + d;
+        const float gy = b * x + 2 * c * y + e;
+        const float g2 = std::max(gx * gx + gy * gy, FLT_MIN);
+        const bool inlier = q * q <= threshold2 * g2;
+        if (inlier) {
+            ++count;
+            squared += q * q / g2;
+        }
+        if (inliers != nullptr) {
+            inliers[i] = inlier ? 1 : 0;
+        }
+    }
+    if (sum_squared != nullptr) {
+        *sum_squared = squared;
+    }
+    return count;
+}
+
+bool EllipseFitter::fit_normalized(EllipseFit& result) {
+    const int n = static_cast<int>(xs_.size());
+    const float threshold = static_cast<float>(params_.inlier_threshold * scale_);
+    cv::Point2d center;
+    double width = 0, height = 0, angle = 0;
+
+    // 只接受确实表示椭圆的二次曲线
+    auto is_ellipse = [&](const double candidate[6]) {
+        return conic_to_ellipse(candidate, center, width, height, angle);
+    };
+
+    double m[5][5];
+    double conic[6];
+    accumulate_moments(xs_.data(), ys_.data(), n, m);
+    bool found = conic_from_moments(m, conic) && is_ellipse(conic);
+    double squared = 0.0;
+    int inliers = found ? count_inliers(conic, threshold, nullptr, &squared) : 0;
+
+    if (params_.mode == ELLIPSE_FIT_RANSAC && inliers < params_.accept_ratio * n) {
+        rng_ = cv::RNG(params_.seed);
+        double best_conic[6];
+        int best_inliers = inliers;
+        bool improved = false;
+        int needed = params_.max_iterations;
+        for (int iteration = 0; iteration < needed; ++iteration) {
+            if (budget_exhausted()) {
+                result.budget_exhausted = true;
+                break;
+            }
+            ++result.iterations;
+
+            // 随机取 6 个不同的点拟合
+            int picked[SAMPLE_SIZE];
+            float sample_x[SAMPLE_SIZE], sample_y[SAMPLE_SIZE];
+            for (int k = 0; k < SAMPLE_SIZE; ++k) {
+                int index;
+                do {
+                    index = rng_.uniform(0, n);
+                } while (std::find(picked, picked + k, index) != picked + k);
+                picked[k] = index;
+                sample_x[k] = xs_[index];
+                sample_y[k] = ys_[index];
+            }
+            double sample_m[5][5];
+            double sample_conic[6];
+            accumulate_moments(sample_x, sample_y, SAMPLE_SIZE, sample_m);
+            if (!conic_from_moments(sample_m, sample_conic) || !is_ellipse(sample_conic)) {
+                continue;
+            }
+
+            const int sample_inliers = count_inliers(sample_conic, threshold, nullptr, nullptr);
+            if (sample_inliers > best_inliers) {
+                best_inliers = sample_inliers;
+                std::copy(sample_conic, sample_conic + 6, best_conic);
+                improved = true;
+
+                // 以当前内点比例估计达到 RANSAC_CONFIDENCE 所需的迭代次数
+                const double all_inliers = std::pow(static_cast<double>(best_inliers) / n, SAMPLE_SIZE);
+                if (all_inliers >= 1.0 - 1e-9) {
+                    break;
+                }
+                const double estimate = std::log(1.0 - RANSAC_CONFIDENCE) / std::log(1.0 - all_inliers);
+                needed = std::min(params_.max_iterations, static_cast<int>(std::ceil(estimate)));
+            }
+        }
+
+        if (improved) {
+            // 用最佳模型的内点重新拟合；重新拟合失败时保留采样得到的模型
+            inlier_flags_.resize(n);
+            count_inliers(best_conic, threshold, inlier_flags_.data(), nullptr);
+            inlier_xs_.clear();
+            inlier_ys_.clear();
+            for (int i = 0; i < n; ++i) {
+                if (inlier_flags_[i]) {
+                    inlier_xs_.push_back(xs_[i]);
+                    inlier_ys_.push_back(ys_[i]);
+                }
+            }
+            double refit_conic[6];
+            accumulate_moments(inlier_xs_.data(), inlier_ys_.data(), static_cast<int>(inlier_xs_.size()), m);
+            const bool refit = static_cast<int>(inlier_xs_.size()) >= SAMPLE_SIZE &&
+                               conic_from_moments(m, refit_conic) && is_ellipse(refit_conic);
+            const double* chosen = refit ? refit_conic : best_conic;
+            std::copy(chosen, chosen + 6, conic);
+            found = true;
+            inliers = count_inliers(conic, threshold, nullptr, &squared);
+        }
+    }
+
+    // 样本检查会改写几何参数，最后由选定的二次曲线重新计算
+    if (!found || !is_ellipse(conic)) {
+        return false;
+    }
+    result.found = true;
+    result.ellipse = cv::RotatedRect(cv::Point2f(static_cast<float>(center.x / scale_ + mean_x_),
+                                                 static_cast<float>(center.y / scale_ + mean_y_)),
+                                     cv::Size2f(static_cast<float>(width / scale_), static_cast<float>(height / scale_)),
+                                     static_cast<float>(angle));
+    result.inliers = inliers;
+    result.rms_residual = inliers > 0 ? static_cast<float>(std::sqrt(squared / inliers) / scale_) : 0.f;
+    return true;
+}
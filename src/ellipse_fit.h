@@ -0,0 +1,118 @@
+#ifndef ELLIPSE_FIT_H
+#define ELLIPSE_FIT_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 椭圆拟合方式。
+ */
+enum EllipseFitMode {
+    ELLIPSE_FIT_DIRECT = 0, ///< 对全部点做一次直接最小二乘拟合
+    ELLIPSE_FIT_RANSAC      ///< 全部点拟合的内点比例不足时，改用 RANSAC 取内点后重新拟合
+};
+
+/**
+ * @struct EllipseFitParams
+ * @brief EllipseFitter 的参数。
+ */
+struct EllipseFitParams {
+    EllipseFitMode mode = ELLIPSE_FIT_RANSAC; ///< 拟合方式
+    double inlier_threshold = 1.5; ///< 内点判定阈值：点到椭圆的近似（Sampson）距离，单位像素
+    double accept_ratio = 0.9;     ///< 全部点拟合的内点比例达到该值时不再做 RANSAC
+    int max_iterations = 64;       ///< 每个轮廓的 RANSAC 迭代上限
+    double frame_budget_ms = 2.0;  ///< 每帧（两次 begin_frame 之间）RANSAC 可用的总时间，<= 0 表示不限
+    uint64_t seed = 0x5eed;        ///< 随机数种子，每个轮廓重新设置，保证结果可复现
+};
+
+/**
+ * @struct EllipseFit
+ * @brief 一次椭圆拟合的结果。
+ */
+struct EllipseFit {
+    bool found = false;           ///< 是否得到了有效椭圆
+    cv::RotatedRect ellipse;      ///< 拟合得到的椭圆（与 cv::fitEllipse 的表示方式相同）
+    int points = 0;               ///< 输入点数
+    int inliers = 0;              ///< 距离不超过 inlier_threshold 的点数
+    int iterations = 0;           ///< 实际执行的 RANSAC 迭代次数
+    float rms_residual = 0.f;     ///< 内点的均方根距离（像素）
+    bool budget_exhausted = false; ///< RANSAC 是否因帧时间预算用尽而提前结束或被跳过
+
+    /**
+     * @brief 内点比例，范围 [0, 1]。
+     */
+    float inlier_ratio() const { return points > 0 ? static_cast<float>(inliers) / points : 0.f; }
+};
+
+/**
+ * @class EllipseFitter
+ * @brief 直接最小二乘椭圆拟合（Fitzgibbon 约束，Halir–Flusser 数值稳定解法），可选 RANSAC。
+ *
+ * 点先平移到质心并缩放到单位尺度，再累加 x^i y^j（i + j <= 4）共 15 个矩得到散布
+ * 矩阵，矩的累加用 OpenCV 通用向量指令实现，拟合本身只是 3x3 矩阵运算和一个
+ * 三次方程，与点数无关。RANSAC 每次取 6 个点拟合，用向量化的 Sampson 距离统计内点，
+ * 迭代次数按当前最佳内点比例自适应减少，最后对最佳模型的内点重新拟合，适合
+ * 被眼睑或光斑遮挡了一部分的瞳孔轮廓。
+ *
+ * 所有 RANSAC 迭代共享一个每帧时间预算（见 begin_frame），超时后剩余轮廓只做
+ * 直接拟合，因此单帧最坏延迟有上界。
+ *
+ * 实例持有复用的缓冲区和随机数发生器，不能被多个线程同时调用。
+ */
+class EllipseFitter {
+public:
+    explicit EllipseFitter(const EllipseFitParams& params = EllipseFitParams());
+
+    /**
+     * @brief 开始新的一帧，重置 RANSAC 的时间预算。
+     */
+    void begin_frame();
+
+    /**
+     * @brief 拟合一个轮廓。
+     * @param contour 轮廓点，至少 6 个。
+     * @param result 拟合结果。
+     * @return 得到有效椭圆时返回 true。
+     */
+    bool fit(const std::vector<cv::Point>& contour, EllipseFit& result);
+
+    /**
+     * @brief 拟合一组浮点坐标点，至少 6 个。
+     */
+    bool fit(const std::vector<cv::Point2f>& points, EllipseFit& result);
+
+    const EllipseFitParams& params() const { return params_; }
+    void set_params(const EllipseFitParams& params) { params_ = params; }
+
+private:
+    /**
+     * @brief 对 xs_/ys_ 中已归一化的点执行拟合，结果换算回原坐标。
+     */
+    bool fit_normalized(EllipseFit& result);
+
+    /**
+     * @brief 统计到 conic 的 Sampson 距离不超过阈值（归一化单位）的点数，
+     * inliers 非空时同时写出每个点是否为内点。
+     */
+    int count_inliers(const double conic[6], float threshold, uint8_t* inliers, double* sum_squared) const;
+
+    /**
+     * @brief 当前帧的 RANSAC 时间预算是否已用尽。
+     */
+    bool budget_exhausted() const;
+
+    EllipseFitParams params_;
+    cv::RNG rng_;
+    int64_t frame_deadline_ = 0; // 0 表示不限时
+
+    // 归一化：x' = (x - mean_x) * scale
+    double mean_x_ = 0, mean_y_ = 0, scale_ = 1;
+
+    // 逐轮廓复用的缓冲区（SoA）
+    std::vector<float> xs_, ys_;
+    std::vector<float> inlier_xs_, inlier_ys_;
+    std::vector<uint8_t> inlier_flags_;
+};
+
+#endif // ELLIPSE_FIT_H
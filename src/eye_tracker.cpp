@@ -0,0 +1,130 @@
+#include "eye_tracker.h"
+#include <algorithm>
+#include <cmath>
+
+// 重新捕获时速度分量的初始方差（像素/帧）^2，速度未知，取较大值
+static const float INITIAL_VELOCITY_VARIANCE = 100.f;
+
+EyeTracker::EyeTracker(const EyeTrackerParams& params, const std::string& eye_cascade_path)
+    : params_(params),
+      reflection_detector_(eye_cascade_path),
+      registration_(params.registration),
+      kalman_(4, 2, 0, CV_32F),
+      measurement_(2, 1, CV_32F) {
+    // 匀速模型：x' = x + vx，y' = y + vy
+    kalman_.transitionMatrix = cv::Mat::eye(4, 4, CV_32F);
+    kalman_.transitionMatrix.at<float>(0, 2) = 1.f;
+    kalman_.transitionMatrix.at<float>(1, 3) = 1.f;
+    kalman_.measurementMatrix = cv::Mat::zeros(2, 4, CV_32F);
+    kalman_.measurementMatrix.at<float>(0, 0) = 1.f;
+    kalman_.measurementMatrix.at<float>(1, 1) = 1.f;
+    cv::setIdentity(kalman_.processNoiseCov, cv::Scalar::all(params_.process_noise * params_.process_noise));
+    cv::setIdentity(kalman_.measurementNoiseCov, cv::Scalar::all(params_.measurement_noise * params_.measurement_noise));
+}
+
+void EyeTracker::reset() {
+    tracking_ = false;
+    low_confidence_frames_ = 0;
+    eye_found_ = false;
+}
+
+void EyeTracker::start_tracking(const cv::Point2f& center) {
+    kalman_.statePost = cv::Mat::zeros(4, 1, CV_32F);
+    kalman_.statePost.at<float>(0) = center.x;
+    kalman_.statePost.at<float>(1) = center.y;
+    cv::setIdentity(kalman_.errorCovPost, cv::Scalar::all(params_.measurement_noise * params_.measurement_noise));
+    kalman_.errorCovPost.at<float>(2, 2) = INITIAL_VELOCITY_VARIANCE;
+    kalman_.errorCovPost.at<float>(3, 3) = INITIAL_VELOCITY_VARIANCE;
+    tracking_ = true;
+    low_confidence_frames_ = 0;
+}
+
+cv::Rect EyeTracker::search_region(const cv::Point2f& predicted, const cv::Size& image_size) const {
+    // 边长取瞳孔尺寸的倍数，并按本帧的预测位移外扩，快速扫视时也不至于丢失
+    const float vx = kalman_.statePost.at<float>(2);
+    const float vy = kalman_.statePost.at<float>(3);
+    const float side = std::max(static_cast<float>(params_.min_roi_size), params_.roi_scale * pupil_major_) +
+                       2.f * (std::abs(vx) + std::abs(vy));
+    const int half = cvCeil(side / 2);
+    const cv::Rect roi(cvRound(predicted.x) - half, cvRound(predicted.y) - half, 2 * half, 2 * half);
+    return roi & cv::Rect(0, 0, image_size.width, image_size.height);
+}
+
+EyeTrackResult EyeTracker::process(const cv::Mat& light_image, const cv::Mat& dark_image) {
+    EyeTrackResult result;
+    if (light_image.empty() || dark_image.empty() || light_image.size() != dark_image.size()) {
+        return result;
+    }
+    const cv::Rect image_rect(0, 0, light_image.cols, light_image.rows);
+
+    // 1. 预测本帧瞳孔位置并确定搜索区域
+    if (tracking_) {
+        const cv::Mat& prediction = kalman_.predict();
+        result.predicted = cv::Point2f(prediction.at<float>(0), prediction.at<float>(1));
+        result.search_roi = search_region(result.predicted, light_image.size());
+    }
+    // 未在跟踪，或预测点已离开图像（搜索区域过小）时整帧搜索
+    if (!tracking_ || result.search_roi.width < 3 || result.search_roi.height < 3) {
+        result.search_roi = image_rect;
+        result.full_frame = true;
+        result.predicted = cv::Point2f(-1.f, -1.f);
+    }
+
+    // 2. 只在搜索区域内配准、差分、二值化并评分，以预测点作为先验中心
+    const cv::Rect& roi = result.search_roi;
+    if (params_.register_frames && !result.full_frame) {
+        registration_.align(light_image, dark_image, roi, aligned_dark_, &result.frame_shift);
+    } else {
+        aligned_dark_ = dark_image(roi);
+    }
+    workspace_.begin_frame();
+    cv::Mat mask;
+    if (!compute_pupil_mask(light_image(roi), aligned_dark_, workspace_, mask)) {
+        return result;
+    }
+    const cv::Point2f offset(static_cast<float>(roi.x), static_cast<float>(roi.y));
+    const cv::Point2f prior = result.full_frame ? cv::Point2f(-1.f, -1.f) : result.predicted - offset;
+    rank_pupil_candidates(light_image(roi), aligned_dark_, mask, workspace_, prior, candidates_);
+    if (!candidates_.empty()) {
+        const PupilCandidate& best = candidates_.best();
+        result.pupil.found = true;
+        result.pupil.ellipse = best.ellipse;
+        result.pupil.ellipse.center += offset;
+        result.pupil.center = result.pupil.ellipse.center;
+        result.pupil.confidence = best.confidence;
+    }
+
+    // 3. 更新跟踪状态：可信的检测修正预测，连续不可信时放弃跟踪
+    const bool confident = result.pupil.found && result.pupil.confidence >= params_.min_confidence;
+    if (confident) {
+        if (result.full_frame) {
+            start_tracking(result.pupil.center);
+        } else {
+            measurement_.at<float>(0) = result.pupil.center.x;
+            measurement_.at<float>(1) = result.pupil.center.y;
+            kalman_.correct(measurement_);
+            low_confidence_frames_ = 0;
+        }
+        pupil_major_ = std::max(result.pupil.ellipse.size.width, result.pupil.ellipse.size.height);
+    } else if (tracking_ && ++low_confidence_frames_ >= params_.max_low_confidence) {
+        tracking_ = false;
+        eye_found_ = false;
+    }
+
+    // 4. 光斑检测：已知眼睛区域时随瞳孔平移，跳过 Haar 级联分类器
+    const bool have_anchor = confident || !result.full_frame;
+    const cv::Point2f anchor = confident ? result.pupil.center : result.predicted;
+    if (eye_found_ && have_anchor) {
+        eye_roi_.x = cvRound(anchor.x + eye_offset_.x);
+        eye_roi_.y = cvRound(anchor.y + eye_offset_.y);
+        result.reflection = reflection_detector_.process(light_image, eye_roi_);
+    } else {
+        result.reflection = reflection_detector_.process(light_image);
+        eye_found_ = result.reflection.eye_found && have_anchor;
+        if (eye_found_) {
+            eye_roi_ = result.reflection.eye_roi;
+            eye_offset_ = cv::Point2f(static_cast<float>(eye_roi_.x), static_cast<float>(eye_roi_.y)) - anchor;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,117 @@
+#ifndef EYE_TRACKER_H
+#define EYE_TRACKER_H
+
+#include "detection.h"
+#include "ellipse_fit.h"
+#include "frame_registration.h"
+#include <opencv2/opencv.hpp>
+#include <string>
+
+/**
+ * @struct EyeTrackerParams
+ * @brief EyeTracker 的参数。
+ */
+struct EyeTrackerParams {
+    float roi_scale = 3.0f;        ///< 搜索区域边长相对上一帧瞳孔长轴的倍数
+    int min_roi_size = 96;         ///< 搜索区域的最小边长（像素）
+    float min_confidence = 0.3f;   ///< 置信度低于该值的帧记为低置信度帧，不用于更新预测
+    int max_low_confidence = 3;    ///< 连续低置信度帧达到该数目后回到整帧搜索
+    float process_noise = 1.0f;    ///< 卡尔曼滤波过程噪声（加速度扰动，像素/帧^2）
+    float measurement_noise = 1.0f; ///< 卡尔曼滤波测量噪声（像素）
+    bool register_frames = true;   ///< 跟踪状态下差分前先在搜索区域内把暗瞳帧对齐到明瞳帧
+    FrameRegistrationParams registration; ///< 明暗帧配准参数
+};
+
+/**
+ * @struct EyeTrackResult
+ * @brief EyeTracker 处理一个明暗帧对的结果，坐标均为整帧坐标。
+ */
+struct EyeTrackResult {
+    PupilResult pupil;              ///< 置信度最高的瞳孔候选
+    ReflectionResult reflection;    ///< 光斑检测结果
+    cv::Rect search_roi;            ///< 本帧瞳孔搜索区域（整帧搜索时为整幅图像）
+    bool full_frame = false;        ///< 本帧是否做了整帧搜索
+    cv::Point2f predicted{-1.f, -1.f}; ///< 卡尔曼滤波预测的瞳孔中心，整帧搜索时为 (-1, -1)
+    cv::Point2d frame_shift;        ///< 差分前对暗瞳帧所做的平移补偿，未配准时为 (0, 0)
+};
+
+/**
+ * @class EyeTracker
+ * @brief 基于时序 ROI 的眼动跟踪器：只在重新捕获时做整帧搜索。
+ *
+ * 跟踪状态下，用匀速模型的卡尔曼滤波（状态 [x, y, vx, vy]，时间单位为帧对）
+ * 预测本帧瞳孔中心，只对以预测点为中心、边长为 roi_scale 倍瞳孔长轴
+ * （至少 min_roi_size，并按当前速度外扩）的区域做差分、二值化和候选评分，
+ * 候选评分以预测点作为“上一帧中心”。差分前先用梯度幅值的互相关估计搜索区域内
+ * 暗瞳帧相对明瞳帧的平移并重采样对齐（见 FrameRegistration），消除两次曝光
+ * 之间眼动造成的月牙形残差。光斑检测跳过 Haar 级联分类器，
+ * 沿用捕获时的眼睛区域并随瞳孔平移。
+ *
+ * 只有连续 max_low_confidence 帧置信度不足时才丢失跟踪，下一帧回到
+ * 整帧搜索（整帧差分 + 整帧 Haar 眼睛检测）。因此稳态下每帧的计算量只与
+ * 搜索区域大小有关，与输入分辨率无关。
+ *
+ * 实例保存逐帧状态和复用的缓冲区，不能被多个线程同时调用；
+ * 双眼或多路视频请各自创建实例。
+ */
+class EyeTracker {
+public:
+    /**
+     * @brief 构造跟踪器并加载眼睛级联分类器。
+     * @param params 跟踪参数。
+     * @param eye_cascade_path Haar 级联分类器 XML 文件路径。
+     */
+    explicit EyeTracker(const EyeTrackerParams& params = EyeTrackerParams(),
+                        const std::string& eye_cascade_path = "haarcascades/haarcascade_eye.xml");
+
+    /**
+     * @brief 处理一个明暗帧对。
+     * @param light_image 明瞳图像。
+     * @param dark_image 暗瞳图像，尺寸和类型须与明瞳图像一致。
+     * @return 本帧的跟踪结果。
+     */
+    EyeTrackResult process(const cv::Mat& light_image, const cv::Mat& dark_image);
+
+    /**
+     * @brief 丢弃跟踪状态，下一帧做整帧搜索。
+     */
+    void reset();
+
+    /**
+     * @brief 当前是否处于跟踪状态（下一帧只搜索 ROI）。
+     */
+    bool is_tracking() const { return tracking_; }
+
+    /**
+     * @brief 连续低置信度帧数。
+     */
+    int low_confidence_frames() const { return low_confidence_frames_; }
+
+private:
+    /**
+     * @brief 以测得的瞳孔中心初始化卡尔曼滤波状态，速度置零。
+     */
+    void start_tracking(const cv::Point2f& center);
+
+    /**
+     * @brief 由预测中心、瞳孔尺寸和速度计算本帧的搜索区域。
+     */
+    cv::Rect search_region(const cv::Point2f& predicted, const cv::Size& image_size) const;
+
+    EyeTrackerParams params_;
+    ReflectionDetector reflection_detector_;
+    PupilWorkspace workspace_; // 搜索区域尺寸逐帧变化，差分图像取自工作区
+    FrameRegistration registration_;
+    cv::KalmanFilter kalman_;
+    cv::Mat aligned_dark_, measurement_;
+    PupilCandidates candidates_;
+
+    bool tracking_ = false;
+    int low_confidence_frames_ = 0;
+    float pupil_major_ = 0.f;      // 最近一次可信检测的瞳孔长轴
+    bool eye_found_ = false;       // 是否已有可用的眼睛区域
+    cv::Rect eye_roi_;             // 最近一次的眼睛区域
+    cv::Point2f eye_offset_;       // 眼睛区域左上角相对瞳孔中心的偏移
+};
+
+#endif // EYE_TRACKER_H
@@ -0,0 +1,305 @@
+#include "fixed_point_pupil.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// 标号表容量（12 位标号，0 为背景）
+static const int MAX_LABELS = 4096;
+
+// 二值化阈值和面积范围，与 preprocess_image / find_best_pupil_ellipse 一致
+static const int BINARY_THRESHOLD = 50;
+static const uint32_t MIN_AREA = 500;
+static const uint32_t MAX_AREA = 3000;
+
+// 外接矩形边长上限：面积小于 MAX_AREA 且长短轴比大于 0.75 的椭圆长轴不超过约 72 像素
+static const int MAX_EXTENT = 128;
+
+// 5 抽头高斯核 [1 4 6 4 1]（和为 16），与 getGaussianKernel(5, 0) 一致
+static const uint32_t GAUSS_TAPS[5] = {1, 4, 6, 4, 1};
+
+// BGR2GRAY 定点系数（14 位小数），与 OpenCV cvtColor 的 8 位实现一致
+static const uint32_t GRAY_B = 1868;
+static const uint32_t GRAY_G = 9617;
+static const uint32_t GRAY_R = 4899;
+static const int GRAY_SHIFT = 14;
+
+/**
+ * @brief BORDER_REFLECT_101 边界下的下标映射（...cb|abcd|cb...）。
+ */
+static int reflect101(int i, int n) {
+    if (n == 1) {
+        return 0;
+    }
+    while (i < 0 || i >= n) {
+        i = i < 0 ? -i : 2 * n - 2 - i;
+    }
+    return i;
+}
+
+/**
+ * @brief 64 位无符号整数平方根（向下取整），逐位实现，对应硬件中的移位减法开方器。
+ */
+static uint64_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = uint64_t(1) << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+void FixedPointPupilModel::begin_frame(int width, int height, int channels) {
+    width_ = width;
+    height_ = height;
+    channels_ = channels;
+    x_ = 0;
+    y_ = 0;
+    next_output_row_ = 0;
+
+    lines_.assign(5 * static_cast<size_t>(width), 0);
+    prev_labels_.assign(width, 0);
+    cur_labels_.assign(width, 0);
+    parent_.resize(MAX_LABELS);
+    stats_.resize(MAX_LABELS);
+    next_label_ = 1;
+    label_overflow_ = false;
+}
+
+void FixedPointPupilModel::push(const uint8_t* light, const uint8_t* dark) {
+    // 1. 逐通道差分；2. 灰度化
+    uint8_t gray;
+    if (channels_ == 3) {
+        const uint32_t b = static_cast<uint32_t>(std::abs(light[0] - dark[0]));
+        const uint32_t g = static_cast<uint32_t>(std::abs(light[1] - dark[1]));
+        const uint32_t r = static_cast<uint32_t>(std::abs(light[2] - dark[2]));
+        gray = static_cast<uint8_t>((b * GRAY_B + g * GRAY_G + r * GRAY_R + (1u << (GRAY_SHIFT - 1))) >> GRAY_SHIFT);
+    } else {
+        gray = static_cast<uint8_t>(std::abs(light[0] - dark[0]));
+    }
+    lines_[(y_ % 5) * width_ + x_] = gray;
+
+    // 输出行比输入行晚两行：第 y 行到达时，第 y - 2 行的纵向窗口已经完整
+    if (y_ >= 2) {
+        column_step(x_, y_ - 2);
+    }
+    if (++x_ == width_) {
+        x_ = 0;
+        ++y_;
+    }
+}
+
+FixedPupilResult FixedPointPupilModel::end_frame() {
+    // 冲刷最后两行（下边界按 REFLECT_101 取已缓冲的行）
+    for (int row = next_output_row_; row < height_; ++row) {
+        for (int x = 0; x < width_; ++x) {
+            column_step(x, row);
+        }
+    }
+
+    FixedPupilResult result;
+    result.label_overflow = label_overflow_;
+    for (uint16_t label = 1; label < next_label_; ++label) {
+        if (parent_[label] != label) {
+            continue;
+        }
+        ++result.components;
+        const LabelStats& s = stats_[label];
+
+        // 面积和外接矩形预筛选，同时保证下面的中间量不超过 64 位
+        if (s.m00 <= MIN_AREA || s.m00 >= MAX_AREA) {
+            continue;
+        }
+        if (s.max_x - s.min_x + 1 > MAX_EXTENT || s.max_y - s.min_y + 1 > MAX_EXTENT) {
+            continue;
+        }
+
+        // 协方差矩阵乘以 n，Q4：a = 16 * n * var(x)，c = 16 * n * var(y)，b = 16 * n * cov(x, y)
+        const int64_t n = s.m00;
+        const int64_t m10 = static_cast<int64_t>(s.m10), m01 = static_cast<int64_t>(s.m01);
+        const int64_t a = ((n * static_cast<int64_t>(s.m20) - m10 * m10) << 4) / n;
+        const int64_t c = ((n * static_cast<int64_t>(s.m02) - m01 * m01) << 4) / n;
+        const int64_t b = ((n * static_cast<int64_t>(s.m11) - m10 * m01) << 4) / n;
+
+        // 特征值 λ = ((a + c) ± sqrt((a - c)^2 + 4b^2)) / 2，轴全长 = 4 * sqrt(λ / (16 n)) * 256
+        const int64_t root = static_cast<int64_t>(isqrt64(static_cast<uint64_t>((a - c) * (a - c) + 4 * b * b)));
+        const int64_t lambda_major = (a + c + root) / 2;
+        const int64_t lambda_minor = std::max<int64_t>(0, (a + c - root) / 2);
+        const int32_t major_q8 = static_cast<int32_t>(isqrt64(static_cast<uint64_t>((lambda_major << 16) / n)));
+        const int32_t minor_q8 = static_cast<int32_t>(isqrt64(static_cast<uint64_t>((lambda_minor << 16) / n)));
+
+        // 短轴 / 长轴 > 0.75
+        if (major_q8 == 0 || 4 * minor_q8 <= 3 * major_q8) {
+            continue;
+        }
+        if (result.found && s.m00 <= result.area) {
+            continue;
+        }
+        result.found = true;
+        result.area = s.m00;
+        result.center_x_q8 = static_cast<int32_t>(((m10 << 8) + n / 2) / n);
+        result.center_y_q8 = static_cast<int32_t>(((m01 << 8) + n / 2) / n);
+        result.major_q8 = major_q8;
+        result.minor_q8 = minor_q8;
+        result.angle = static_cast<float>(0.5 * std::atan2(2.0 * b, static_cast<double>(a - c)) * 180.0 / CV_PI);
+    }
+    return result;
+}
+
+void FixedPointPupilModel::column_step(int x, int row) {
+    // 3. 纵向 [1 4 6 4 1]，最大 255 * 16 = 4080，12 位
+    uint32_t sum = 0;
+    for (int k = 0; k < 5; ++k) {
+        const int line = reflect101(row - 2 + k, height_) % 5;
+        sum += GAUSS_TAPS[k] * lines_[line * width_ + x];
+    }
+    column_sums_[x % 5] = static_cast<uint16_t>(sum);
+
+    // 输出列比当前列晚两列，行末补齐最后两列
+    if (x >= 2) {
+        blur_output(x - 2, row);
+    }
+    if (x == width_ - 1) {
+        for (int out = std::max(0, width_ - 2); out < width_; ++out) {
+            blur_output(out, row);
+        }
+        next_output_row_ = row + 1;
+    }
+}
+
+void FixedPointPupilModel::blur_output(int x, int row) {
+    // 横向 [1 4 6 4 1]，最大 4080 * 16 = 65280，16 位；除以 256 并四舍五入
+    uint32_t sum = 0;
+    for (int k = 0; k < 5; ++k) {
+        sum += GAUSS_TAPS[k] * column_sums_[reflect101(x - 2 + k, width_) % 5];
+    }
+    const uint8_t blurred = static_cast<uint8_t>((sum + 128) >> 8);
+
+    // 4. 二值化
+    const bool foreground = blurred > BINARY_THRESHOLD;
+    if (mask_out_ != nullptr) {
+        mask_out_->at<uchar>(row, x) = foreground ? 255 : 0;
+    }
+
+    // 5. 连通域标记
+    label_pixel(x, row, foreground);
+}
+
+uint16_t FixedPointPupilModel::find_root(uint16_t label) {
+    while (parent_[label] != label) {
+        parent_[label] = parent_[parent_[label]];
+        label = parent_[label];
+    }
+    return label;
+}
+
+uint16_t FixedPointPupilModel::merge_labels(uint16_t a, uint16_t b) {
+    if (a == b) {
+        return a;
+    }
+    const uint16_t root = std::min(a, b);
+    const uint16_t child = std::max(a, b);
+    parent_[child] = root;
+
+    LabelStats& dst = stats_[root];
+    const LabelStats& src = stats_[child];
+    dst.m00 += src.m00;
+    dst.m10 += src.m10;
+    dst.m01 += src.m01;
+    dst.m20 += src.m20;
+    dst.m11 += src.m11;
+    dst.m02 += src.m02;
+    dst.min_x = std::min(dst.min_x, src.min_x);
+    dst.min_y = std::min(dst.min_y, src.min_y);
+    dst.max_x = std::max(dst.max_x, src.max_x);
+    dst.max_y = std::max(dst.max_y, src.max_y);
+    return root;
+}
+
+void FixedPointPupilModel::label_pixel(int x, int y, bool foreground) {
+    uint16_t label = 0;
+    if (foreground) {
+        // 已处理的 8 邻域：左、左上、上、右上
+        const uint16_t neighbors[4] = {
+            x > 0 ? cur_labels_[x - 1] : uint16_t(0),
+            x > 0 ? prev_labels_[x - 1] : uint16_t(0),
+            prev_labels_[x],
+            x + 1 < width_ ? prev_labels_[x + 1] : uint16_t(0),
+        };
+        for (uint16_t neighbor : neighbors) {
+            if (neighbor != 0) {
+                const uint16_t root = find_root(neighbor);
+                label = label == 0 ? root : merge_labels(label, root);
+            }
+        }
+
+        if (label == 0) {
+            if (next_label_ < MAX_LABELS) {
+                label = next_label_++;
+                parent_[label] = label;
+                LabelStats& s = stats_[label];
+                s = LabelStats();
+                s.min_x = s.max_x = static_cast<uint16_t>(x);
+                s.min_y = s.max_y = static_cast<uint16_t>(y);
+            } else {
+                label_overflow_ = true;
+            }
+        }
+        if (label != 0) {
+            const uint64_t ux = static_cast<uint64_t>(x);
+            const uint64_t uy = static_cast<uint64_t>(y);
+            LabelStats& s = stats_[label];
+            s.m00 += 1;
+            s.m10 += ux;
+            s.m01 += uy;
+            s.m20 += ux * ux;
+            s.m11 += ux * uy;
+            s.m02 += uy * uy;
+            s.min_x = std::min(s.min_x, static_cast<uint16_t>(x));
+            s.max_x = std::max(s.max_x, static_cast<uint16_t>(x));
+            s.max_y = static_cast<uint16_t>(y);
+        }
+    }
+    cur_labels_[x] = label;
+
+    if (x == width_ - 1) {
+        std::swap(prev_labels_, cur_labels_);
+    }
+}
+
+FixedPupilResult FixedPointPupilModel::process(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat* binary_mask) {
+    if (light_image.empty() || dark_image.empty()) {
+        return FixedPupilResult();
+    }
+    if (light_image.size() != dark_image.size() || light_image.type() != dark_image.type() ||
+        (light_image.type() != CV_8UC1 && light_image.type() != CV_8UC3)) {
+        std::cerr << "Error: Fixed-point model expects two 8-bit images of the same size and type." << std::endl;
+        return FixedPupilResult();
+    }
+
+    const int channels = light_image.channels();
+    if (binary_mask != nullptr) {
+        binary_mask->create(light_image.size(), CV_8UC1);
+    }
+    mask_out_ = binary_mask;
+
+    begin_frame(light_image.cols, light_image.rows, channels);
+    for (int y = 0; y < light_image.rows; ++y) {
+        const uint8_t* light = light_image.ptr<uint8_t>(y);
+        const uint8_t* dark = dark_image.ptr<uint8_t>(y);
+        for (int x = 0; x < light_image.cols; ++x) {
+            push(light + x * channels, dark + x * channels);
+        }
+    }
+    FixedPupilResult result = end_frame();
+    mask_out_ = nullptr;
+    return result;
+}
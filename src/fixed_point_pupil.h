@@ -0,0 +1,125 @@
+#ifndef FIXED_POINT_PUPIL_H
+#define FIXED_POINT_PUPIL_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct FixedPupilResult
+ * @brief 定点模型输出的瞳孔估计。坐标和轴长均为 Q8 定点数（单位：像素 / 256）。
+ */
+struct FixedPupilResult {
+    bool found = false;          ///< 是否找到符合条件的连通域
+    int32_t center_x_q8 = -256;  ///< 中心 x（Q8）
+    int32_t center_y_q8 = -256;  ///< 中心 y（Q8）
+    int32_t major_q8 = 0;        ///< 等效椭圆长轴全长（Q8）
+    int32_t minor_q8 = 0;        ///< 等效椭圆短轴全长（Q8）
+    uint32_t area = 0;           ///< 连通域像素数
+    float angle = 0.f;           ///< 长轴方向（度），仅供参考，不属于定点输出
+    uint16_t components = 0;     ///< 本帧连通域总数
+    bool label_overflow = false; ///< 标号表是否溢出（溢出后的新连通域被忽略）
+
+    /**
+     * @brief 以浮点像素坐标返回中心。
+     */
+    cv::Point2f center() const { return cv::Point2f(center_x_q8 / 256.f, center_y_q8 / 256.f); }
+};
+
+/**
+ * @class FixedPointPupilModel
+ * @brief detect_pupil 路径的逐像素流式定点模型，作为 FPGA 移植的参考实现。
+ *
+ * 每一步输入一对明/暗瞳像素（按光栅顺序），依次完成：
+ *   1. 逐通道差分 |light - dark|（8 位）；
+ *   2. 三通道输入按 BGR2GRAY 定点系数 (1868, 9617, 4899) >> 14 转灰度（8 位）；
+ *   3. 5x5 高斯 [1 4 6 4 1]^T [1 4 6 4 1]，BORDER_REFLECT_101，(sum + 128) >> 8
+ *      （列和 12 位，总和 16 位），输出相对输入延迟两行两列；
+ *   4. 阈值 > 50 二值化；
+ *   5. 单遍 8 邻域连通域标记，每个标号累加 m00 (32 位) 和 m10/m01/m20/m11/m02 (64 位)
+ *      以及外接矩形，标号合并时累加量一并合并。
+ * 帧结束时由二阶矩计算等效椭圆，按面积和长短轴比筛选，取面积最大的连通域。
+ *
+ * 除行缓冲（5 行灰度、2 行标号）和标号表（4096 项）外不保存整帧数据。前四步与 OpenCV 的
+ * 8 位实现逐像素一致；第 5 步用矩等效椭圆代替轮廓跟踪 + 椭圆拟合，
+ * 与浮点路径存在小的偏差（见 test_only/fixed_point_check.cpp）。
+ */
+class FixedPointPupilModel {
+public:
+    /**
+     * @brief 开始新的一帧。
+     * @param width 帧宽度。
+     * @param height 帧高度。
+     * @param channels 每个像素的通道数（1 或 3）。
+     */
+    void begin_frame(int width, int height, int channels);
+
+    /**
+     * @brief 输入下一对像素（光栅顺序）。
+     * @param light 明瞳像素，channels 个字节（BGR 顺序）。
+     * @param dark 暗瞳像素，channels 个字节。
+     */
+    void push(const uint8_t* light, const uint8_t* dark);
+
+    /**
+     * @brief 结束当前帧：冲刷行缓冲中剩余的两行并计算结果。
+     */
+    FixedPupilResult end_frame();
+
+    /**
+     * @brief 以流式方式处理一对完整图像，便于与浮点路径对比。
+     * @param light_image 明瞳图像（CV_8UC1 或 CV_8UC3）。
+     * @param dark_image 暗瞳图像，尺寸和类型与明瞳图像相同。
+     * @param binary_mask 非空时输出模型产生的二值图像（仅用于比对）。
+     */
+    FixedPupilResult process(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat* binary_mask = nullptr);
+
+private:
+    /**
+     * @brief 每个标号的累加量。
+     */
+    struct LabelStats {
+        uint32_t m00;
+        uint64_t m10, m01, m20, m11, m02;
+        uint16_t min_x, min_y, max_x, max_y;
+    };
+
+    /**
+     * @brief 计算输出行 row 第 x 列的纵向加权和，并输出此时已具备全部 5 列的像素。
+     */
+    void column_step(int x, int row);
+
+    /**
+     * @brief 横向加权、舍入、二值化，并把结果送入连通域标记。
+     */
+    void blur_output(int x, int row);
+
+    /**
+     * @brief 连通域标记的单像素步骤（光栅顺序）。
+     */
+    void label_pixel(int x, int y, bool foreground);
+
+    uint16_t find_root(uint16_t label);
+
+    /**
+     * @brief 合并两个根标号，较小者为新根，累加量并入新根。
+     */
+    uint16_t merge_labels(uint16_t a, uint16_t b);
+
+    int width_ = 0, height_ = 0, channels_ = 1;
+    int x_ = 0, y_ = 0;         // 下一个输入像素的位置
+    int next_output_row_ = 0;   // 下一个待输出的行
+
+    std::vector<uint8_t> lines_;        // 5 行灰度行缓冲（按行号 % 5 存放）
+    uint16_t column_sums_[5] = {};      // 最近 5 列的纵向加权和（按列号 % 5 存放）
+    std::vector<uint16_t> prev_labels_; // 上一行的标号
+    std::vector<uint16_t> cur_labels_;  // 当前行的标号
+
+    std::vector<uint16_t> parent_;      // 并查集父节点
+    std::vector<LabelStats> stats_;     // 每个根标号的累加量
+    uint16_t next_label_ = 1;
+    bool label_overflow_ = false;
+    cv::Mat* mask_out_ = nullptr;
+};
+
+#endif // FIXED_POINT_PUPIL_H
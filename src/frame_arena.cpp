@@ -0,0 +1,37 @@
+#include "frame_arena.h"
+
+// 视图起始地址的对齐字节数，与 cv::fastMalloc 一致
+static const size_t ARENA_ALIGNMENT = 64;
+
+static size_t align_up(size_t bytes) {
+    return (bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+void FrameArena::reserve(size_t bytes) {
+    if (bytes > capacity()) {
+        buffer_.create(1, static_cast<int>(align_up(bytes)), CV_8UC1);
+    }
+    used_ = 0;
+    demand_ = 0;
+}
+
+void FrameArena::reset() {
+    // 上一帧有溢出时按其峰值用量一次性扩容，之后同样的用量都能放下
+    if (demand_ > capacity()) {
+        reserve(demand_);
+    }
+    used_ = 0;
+    demand_ = 0;
+}
+
+cv::Mat FrameArena::mat(int rows, int cols, int type) {
+    const size_t bytes = align_up(static_cast<size_t>(rows) * cols * CV_ELEM_SIZE(type));
+    demand_ += bytes;
+    if (used_ + bytes > capacity()) {
+        ++overflows_;
+        return cv::Mat(rows, cols, type);
+    }
+    cv::Mat view(rows, cols, type, buffer_.data + used_);
+    used_ += bytes;
+    return view;
+}
@@ -0,0 +1,52 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+
+/**
+ * @class FrameArena
+ * @brief 按帧重置的线性分配器，中间结果都是同一块预分配内存上的 cv::Mat 视图。
+ *
+ * 每帧开始时调用 reset()，之后 mat() 依次从缓冲区中切出连续的视图（按 64 字节对齐），
+ * 视图不持有引用计数，只在下一次 reset() 之前有效。视图尺寸与类型和 OpenCV 函数
+ * 的输出一致时，函数内部的 create() 不会重新分配，结果直接写入缓冲区。
+ *
+ * 容量不足时 mat() 退回普通的堆分配并计入 overflows()，下一次 reset() 按本帧的
+ * 峰值用量扩容，因此经过一帧预热（或事先 reserve）后稳态运行没有堆分配。
+ * 一个实例不能被多个线程同时使用。
+ */
+class FrameArena {
+public:
+    /**
+     * @brief 预留至少 bytes 字节。会使已切出的视图失效，只能在帧之间调用。
+     */
+    void reserve(size_t bytes);
+
+    /**
+     * @brief 开始新的一帧：回收所有视图，必要时按上一帧的峰值用量扩容。
+     */
+    void reset();
+
+    /**
+     * @brief 切出一块 rows x cols、类型为 type 的连续视图，内容未初始化。
+     */
+    cv::Mat mat(int rows, int cols, int type);
+    cv::Mat mat(const cv::Size& size, int type) { return mat(size.height, size.width, type); }
+
+    size_t capacity() const { return buffer_.empty() ? 0 : buffer_.total(); }
+    size_t used() const { return used_; }
+
+    /**
+     * @brief 因容量不足退回堆分配的次数（累计）。
+     */
+    size_t overflows() const { return overflows_; }
+
+private:
+    cv::Mat buffer_;        // 1 行 CV_8U 的底层存储
+    size_t used_ = 0;
+    size_t demand_ = 0;     // 本帧请求的总字节数（含溢出部分）
+    size_t overflows_ = 0;
+};
+
+#endif // FRAME_ARENA_H
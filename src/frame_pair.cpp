@@ -0,0 +1,118 @@
+#include "frame_pair.h"
+#include <algorithm>
+
+// 锁定后每隔多少对复核一次明瞳奇偶位（没有时间戳可用时，丢帧后的最长恢复窗口取决于它）
+const int PARITY_RECHECK_INTERVAL = 8;
+// 连续多少次复核与锁定结果矛盾时翻转奇偶位
+const int PARITY_FLIP_MISMATCHES = 2;
+// 相邻两帧的时间间隔超过平均帧间隔的多少倍时认为发生了丢帧
+const double PARITY_GAP_FACTOR = 1.5;
+// 检测到丢帧后连续逐对复核的对数
+const int PARITY_GAP_CHECKS = 2 * PARITY_FLIP_MISMATCHES;
+
+FramePairDemuxer::FramePairDemuxer(const cv::Rect& roi, int pair_slots, int calibration_pairs)
+    : roi_(roi),
+      calibration_pairs_(std::max(1, calibration_pairs)),
+      buffers_(2 * static_cast<size_t>(std::max(1, pair_slots))) {}
+
+void FramePairDemuxer::reset() {
+    write_slot_ = 0;
+    frame_count_ = 0;
+    pair_count_ = 0;
+    bright_parity_ = -1;
+    votes_ = 0;
+    mismatches_ = 0;
+    gap_checks_ = 0;
+    last_timestamp_ = -1.0;
+    frame_interval_ = 0.0;
+    first_frame_.release();
+}
+
+void FramePairDemuxer::note_timestamp(double timestamp) {
+    if (last_timestamp_ >= 0.0 && timestamp > last_timestamp_) {
+        const double interval = timestamp - last_timestamp_;
+        if (frame_interval_ > 0.0 && interval > PARITY_GAP_FACTOR * frame_interval_) {
+            // 时间戳出现空档，可能丢了奇数帧：接下来逐对复核，丢帧时两对之内纠正奇偶位
+            gap_checks_ = PARITY_GAP_CHECKS;
+        } else {
+            frame_interval_ = frame_interval_ > 0.0 ? 0.9 * frame_interval_ + 0.1 * interval : interval;
+        }
+    }
+    last_timestamp_ = timestamp;
+}
+
+double FramePairDemuxer::roi_mean(const cv::Mat& frame) const {
+    cv::Rect roi = roi_;
+    if (roi.empty()) {
+        // 默认取画面中央区域，避开四周的暗角和杂散反光
+        roi = cv::Rect(frame.cols / 4, frame.rows / 4, frame.cols / 2, frame.rows / 2);
+    }
+    roi &= cv::Rect(0, 0, frame.cols, frame.rows);
+    if (roi.empty()) {
+        return 0.0;
+    }
+    return cv::mean(frame(roi))[0];
+}
+
+bool FramePairDemuxer::needs_brightness_check() const {
+    return bright_parity_ < 0 || gap_checks_ > 0 || pair_count_ % PARITY_RECHECK_INTERVAL == 0;
+}
+
+bool FramePairDemuxer::commit(double timestamp, FramePair& pair) {
+    const size_t slot = write_slot_;
+    write_slot_ = (write_slot_ + 1) % buffers_.size();
+    return commit_external(buffers_[slot], timestamp, pair);
+}
+
+bool FramePairDemuxer::commit_external(const cv::Mat& frame, double timestamp, FramePair& pair) {
+    note_timestamp(timestamp);
+    if (frame_count_++ % 2 == 0) {
+        // 一对中的第一帧，等待第二帧到来（只保存图像头，不拷贝像素）
+        first_frame_ = frame;
+        first_timestamp_ = timestamp;
+        first_measured_ = needs_brightness_check();
+        first_mean_ = first_measured_ ? roi_mean(frame) : 0.0;
+        return false;
+    }
+    if (needs_brightness_check() && !first_measured_) {
+        // 空档出现在一对的两帧之间
+        first_mean_ = roi_mean(first_frame_);
+    }
+
+    bool first_is_bright;
+    if (bright_parity_ < 0) {
+        // 投票阶段：逐对比较亮度
+        first_is_bright = first_mean_ >= roi_mean(frame);
+        votes_ += first_is_bright ? 1 : -1;
+        if (pair_count_ + 1 >= calibration_pairs_) {
+            bright_parity_ = votes_ >= 0 ? 0 : 1;
+        }
+    } else {
+        if (needs_brightness_check()) {
+            // 复核：丢帧会使明暗帧在一对中的先后顺序翻转
+            bool measured_first_bright = first_mean_ >= roi_mean(frame);
+            if (measured_first_bright != (bright_parity_ == 0)) {
+                if (++mismatches_ >= PARITY_FLIP_MISMATCHES) {
+                    bright_parity_ = 1 - bright_parity_;
+                    mismatches_ = 0;
+                }
+            } else {
+                mismatches_ = 0;
+            }
+            gap_checks_ = std::max(0, gap_checks_ - 1);
+        }
+        first_is_bright = bright_parity_ == 0;
+    }
+
+    pair.light = first_is_bright ? first_frame_ : frame;
+    pair.dark = first_is_bright ? frame : first_frame_;
+    pair.light_timestamp = first_is_bright ? first_timestamp_ : timestamp;
+    pair.dark_timestamp = first_is_bright ? timestamp : first_timestamp_;
+    pair.index = pair_count_++;
+    return true;
+}
+
+bool FramePairDemuxer::push(const cv::Mat& frame, double timestamp, FramePair& pair) {
+    frame.copyTo(next_buffer());
+    return commit(timestamp, pair);
+}
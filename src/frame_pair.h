@@ -0,0 +1,136 @@
+#ifndef FRAME_PAIR_H
+#define FRAME_PAIR_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct FramePair
+ * @brief 一组同步的明瞳/暗瞳帧。
+ *
+ * light 和 dark 只是图像头，引用 FramePairDemuxer 内部的帧缓冲区，不做拷贝。
+ */
+struct FramePair {
+    cv::Mat light;                ///< 明瞳帧（红外光与视轴同轴）
+    cv::Mat dark;                 ///< 暗瞳帧（红外光与视轴异轴）
+    double light_timestamp = 0.0; ///< 明瞳帧时间戳（秒）
+    double dark_timestamp = 0.0;  ///< 暗瞳帧时间戳（秒）
+    int64_t index = 0;            ///< 帧对序号，从 0 开始
+};
+
+/**
+ * @class FramePairDemuxer
+ * @brief 将明暗光源逐帧交替的单路视频拆分为同步的明瞳/暗瞳帧对。
+ *
+ * 相邻两帧组成一对。哪一个奇偶位是明瞳帧由 ROI 内的平均亮度自动判断：
+ * 前 calibration_pairs 对逐对比较并投票，之后锁定结果，并每隔 8 对复核一次，
+ * 以便在相机丢帧导致奇偶翻转时重新对齐；连续 2 次复核矛盾才翻转。
+ *
+ * 时间戳出现空档（超过平均帧间隔的 1.5 倍）时认为可能丢帧，之后逐对复核，
+ * 丢了奇数帧时最多 2 对明暗颠倒。没有可用时间戳（例如全为 0）时只能靠周期复核，
+ * 恢复窗口最长约 16 对。
+ *
+ * 解复用器持有 2 * pair_slots 个帧缓冲区并轮换使用。帧源通过 next_buffer()
+ * 直接把下一帧解码进缓冲区，再调用 commit()；输出的帧对引用这些缓冲区，
+ * 在其后 pair_slots 对被输出之前一直有效，整个过程没有额外拷贝。
+ *
+ * 典型用法：
+ * @code
+ * VideoFrameSource source;
+ * FramePairDemuxer demuxer;
+ * FramePair pair;
+ * double timestamp = 0.0;
+ * while (source.read_into(demuxer.next_buffer(), &timestamp)) {
+ *     if (demuxer.commit(timestamp, pair)) {
+ *         PupilResult pupil = detect_pupil(pair.light, pair.dark);
+ *     }
+ * }
+ * @endcode
+ */
+class FramePairDemuxer {
+public:
+    /**
+     * @brief 构造解复用器。
+     * @param roi 用于比较亮度的区域；为空时使用画面中央一半宽高的区域。
+     * @param pair_slots 同时保持有效的帧对数量，流水线中下游持有帧对越多，这个值需要越大。
+     * @param calibration_pairs 锁定明瞳奇偶位之前用于投票的帧对数量。
+     */
+    explicit FramePairDemuxer(const cv::Rect& roi = cv::Rect(), int pair_slots = 1, int calibration_pairs = 8);
+
+    /**
+     * @brief 下一帧应写入的缓冲区。
+     */
+    cv::Mat& next_buffer() { return buffers_[write_slot_]; }
+
+    /**
+     * @brief 提交已写入 next_buffer() 的一帧。
+     * @param timestamp 该帧的时间戳（秒）。
+     * @param pair 凑齐一对时输出的帧对。
+     * @return 凑齐一对时返回 true。
+     */
+    bool commit(double timestamp, FramePair& pair);
+
+    /**
+     * @brief 提交一帧由调用方持有缓冲区的图像，不做拷贝。
+     *
+     * 输出的帧对直接引用调用方的缓冲区，调用方需保证这两帧在帧对使用完毕前
+     * 不被覆盖（例如 FrameRing 的槽位）。
+     */
+    bool commit_external(const cv::Mat& frame, double timestamp, FramePair& pair);
+
+    /**
+     * @brief 提交一帧外部图像（会拷贝进内部缓冲区），用于无法直接写入缓冲区的帧源。
+     */
+    bool push(const cv::Mat& frame, double timestamp, FramePair& pair);
+
+    /**
+     * @brief 明瞳帧在一对中的位置：0 表示先到的帧，1 表示后到的帧，尚未锁定时为 -1。
+     */
+    int bright_parity() const { return bright_parity_; }
+
+    /**
+     * @brief 清空状态并重新开始奇偶判断，用于切换视频源。
+     */
+    void reset();
+
+private:
+    /**
+     * @brief 计算一帧在亮度比较区域内的平均灰度。
+     */
+    double roi_mean(const cv::Mat& frame) const;
+
+    /**
+     * @brief 记录一帧的时间戳，间隔明显变大时安排逐对复核。
+     */
+    void note_timestamp(double timestamp);
+
+    /**
+     * @brief 本对是否需要计算亮度（投票阶段、复核周期或丢帧后的逐对复核）。
+     */
+    bool needs_brightness_check() const;
+
+    cv::Rect roi_;
+    int calibration_pairs_;
+    std::vector<cv::Mat> buffers_;
+    size_t write_slot_ = 0;
+
+    int64_t frame_count_ = 0;
+    int64_t pair_count_ = 0;
+
+    // 一对中先到的帧
+    cv::Mat first_frame_;
+    double first_timestamp_ = 0.0;
+    double first_mean_ = 0.0;
+    bool first_measured_ = false; // first_mean_ 是否已计算
+
+    int bright_parity_ = -1; // 锁定后的明瞳奇偶位
+    int votes_ = 0;          // 投票阶段：先到帧更亮记 +1，否则记 -1
+    int mismatches_ = 0;     // 复核时连续与锁定结果矛盾的次数
+    int gap_checks_ = 0;     // 检测到时间戳空档后剩余的逐对复核次数
+
+    double last_timestamp_ = -1.0; // 上一帧的时间戳
+    double frame_interval_ = 0.0;  // 平均帧间隔（秒），0 表示尚未估计
+};
+
+#endif // FRAME_PAIR_H
@@ -0,0 +1,158 @@
+#include "frame_registration.h"
+#include <algorithm>
+#include <cmath>
+
+// 模板（区域去掉四周搜索半径后）的最小边长，更小的区域上峰值不可靠
+static const int MIN_REGISTRATION_SIZE = 16;
+
+// 计算梯度幅值前的高斯模糊标准差，抑制传感器噪声
+static const double GRADIENT_SIGMA = 1.5;
+
+FrameRegistration::FrameRegistration(const FrameRegistrationParams& params) : params_(params) {}
+
+cv::Mat FrameRegistration::to_float_gray(const cv::Mat& image) {
+    cv::Mat dst = arena_.mat(image.size(), CV_32F);
+    if (image.channels() == 3) {
+        cv::Mat gray = arena_.mat(image.size(), CV_MAKETYPE(image.depth(), 1));
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+        gray.convertTo(dst, CV_32F);
+    } else {
+        image.convertTo(dst, CV_32F);
+    }
+    return dst;
+}
+
+cv::Mat FrameRegistration::gradient_magnitude(cv::Mat& image) {
+    cv::GaussianBlur(image, image, cv::Size(), GRADIENT_SIGMA);
+    cv::Sobel(image, grad_x_, CV_32F, 1, 0, 3);
+    cv::Sobel(image, grad_y_, CV_32F, 0, 1, 3);
+    cv::Mat dst = arena_.mat(image.size(), CV_32F);
+    cv::magnitude(grad_x_, grad_y_, dst);
+    return dst;
+}
+
+void FrameRegistration::match_template(const cv::Mat& image, const cv::Mat& templ) {
+    match_ = arena_.mat(image.rows - templ.rows + 1, image.cols - templ.cols + 1, CV_32F);
+
+    // 相关项 C(s) = sum_t T'(t) I(t + s)，T' 为去均值的模板；s 不超过 image 与模板的尺寸差，
+    // 补零到不小于 image 的 DFT 尺寸即不会回绕
+    const cv::Size dft_size(cv::getOptimalDFTSize(image.cols), cv::getOptimalDFTSize(image.rows));
+    dft_buffer_ = arena_.mat(dft_size, CV_32F);
+    image_spectrum_ = arena_.mat(dft_size, CV_32F);
+    templ_spectrum_ = arena_.mat(dft_size, CV_32F);
+
+    cv::Scalar templ_mean, templ_stddev;
+    cv::meanStdDev(templ, templ_mean, templ_stddev);
+    const double area = static_cast<double>(templ.total());
+    const double templ_norm = templ_stddev[0] * std::sqrt(area);
+
+    dft_buffer_.setTo(0);
+    cv::Mat centered = dft_buffer_(cv::Rect(cv::Point(), templ.size()));
+    templ.convertTo(centered, CV_32F, 1.0, -templ_mean[0]);
+    cv::dft(dft_buffer_, templ_spectrum_, 0, templ.rows);
+    dft_buffer_.setTo(0);
+    cv::Mat padded = dft_buffer_(cv::Rect(cv::Point(), image.size()));
+    image.copyTo(padded);
+    cv::dft(dft_buffer_, image_spectrum_, 0, image.rows);
+    cv::mulSpectrums(image_spectrum_, templ_spectrum_, image_spectrum_, 0, true);
+    cv::idft(image_spectrum_, dft_buffer_, cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+
+    // 模板已去均值，C(s) 即与去均值窗口的相关；再除以模板和窗口的范数，窗口的和与平方和取自积分图
+    sum_ = arena_.mat(image.rows + 1, image.cols + 1, CV_64F);
+    sqsum_ = arena_.mat(image.rows + 1, image.cols + 1, CV_64F);
+    cv::integral(image, sum_, sqsum_, CV_64F, CV_64F);
+    for (int y = 0; y < match_.rows; ++y) {
+        const double* sum_top = sum_.ptr<double>(y);
+        const double* sum_bottom = sum_.ptr<double>(y + templ.rows);
+        const double* sqsum_top = sqsum_.ptr<double>(y);
+        const double* sqsum_bottom = sqsum_.ptr<double>(y + templ.rows);
+        const float* corr_row = dft_buffer_.ptr<float>(y);
+        float* match_row = match_.ptr<float>(y);
+        for (int x = 0; x < match_.cols; ++x) {
+            const int right = x + templ.cols;
+            const double window_sum = sum_bottom[right] - sum_bottom[x] - sum_top[right] + sum_top[x];
+            const double window_sqsum = sqsum_bottom[right] - sqsum_bottom[x] - sqsum_top[right] + sqsum_top[x];
+            const double denom = templ_norm * std::sqrt(std::max(0.0, window_sqsum - window_sum * window_sum / area));
+            const double score = denom > 0 ? corr_row[x] / denom : 0.0;
+            match_row[x] = static_cast<float>(std::max(-1.0, std::min(1.0, score)));
+        }
+    }
+}
+
+/**
+ * @brief 三点抛物线拟合的极值偏移量，限制在 [-0.5, 0.5]；曲线不是凸的则返回 0。
+ */
+static double parabola_offset(float left, float center, float right) {
+    const double denom = static_cast<double>(left) - 2.0 * center + right;
+    if (denom >= 0) {
+        return 0.0;
+    }
+    return std::max(-0.5, std::min(0.5, 0.5 * (left - right) / denom));
+}
+
+bool FrameRegistration::estimate(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Rect& roi,
+                                 cv::Point2d& shift) {
+    shift = cv::Point2d(0, 0);
+    response_ = 0.0;
+    const cv::Rect region = roi & cv::Rect(0, 0, light_image.cols, light_image.rows);
+    const int radius = cvCeil(params_.max_shift);
+    if (light_image.size() != dark_image.size() || light_image.type() != dark_image.type() || radius < 1 ||
+        region.width - 2 * radius < MIN_REGISTRATION_SIZE || region.height - 2 * radius < MIN_REGISTRATION_SIZE) {
+        return false;
+    }
+
+    arena_.reset();
+    cv::Mat light_float = to_float_gray(light_image(region));
+    cv::Mat dark_float = to_float_gray(dark_image(region));
+    grad_x_ = arena_.mat(region.size(), CV_32F);
+    grad_y_ = arena_.mat(region.size(), CV_32F);
+    light_grad_ = gradient_magnitude(light_float);
+    dark_grad_ = gradient_magnitude(dark_float);
+
+    // 明瞳区域去掉四周 radius 像素作为模板，在暗瞳区域内 ±radius 的范围内搜索；
+    // 匹配位置 p 对应 dark(x) ≈ light(x - (p - radius))
+    const cv::Mat templ = light_grad_(cv::Rect(radius, radius, region.width - 2 * radius, region.height - 2 * radius));
+    match_template(dark_grad_, templ);
+    double peak = 0.0;
+    cv::Point loc;
+    cv::minMaxLoc(match_, nullptr, &peak, nullptr, &loc);
+    response_ = peak;
+    // 峰值落在搜索范围边缘时实际平移可能超出范围
+    if (peak < params_.min_response || loc.x == 0 || loc.y == 0 || loc.x == match_.cols - 1 ||
+        loc.y == match_.rows - 1) {
+        return false;
+    }
+
+    const float* row = match_.ptr<float>(loc.y);
+    const cv::Point2d estimated(
+        loc.x - radius + parabola_offset(row[loc.x - 1], row[loc.x], row[loc.x + 1]),
+        loc.y - radius + parabola_offset(match_.at<float>(loc.y - 1, loc.x), row[loc.x],
+                                         match_.at<float>(loc.y + 1, loc.x)));
+    if (std::abs(estimated.x) > params_.max_shift || std::abs(estimated.y) > params_.max_shift) {
+        return false;
+    }
+    shift = estimated;
+    return true;
+}
+
+bool FrameRegistration::align(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Rect& roi,
+                              cv::Mat& aligned_dark, cv::Point2d* shift) {
+    cv::Point2d estimated;
+    const bool ok = estimate(light_image, dark_image, roi, estimated);
+    if (shift != nullptr) {
+        *shift = estimated;
+    }
+    if (!ok) {
+        aligned_dark = dark_image(roi);
+        return false;
+    }
+
+    // aligned(x) = dark(x + roi.tl() + shift)，只计算 roi 大小的输出
+    const cv::Matx23d transform(1, 0, roi.x + estimated.x, 0, 1, roi.y + estimated.y);
+    // 写入自有缓冲区：aligned_dark 可能是上一次返回的 dark_image(roi) 图像头，不能直接作为输出
+    warped_ = arena_.mat(roi.size(), dark_image.type());
+    cv::warpAffine(dark_image, warped_, transform, roi.size(), cv::INTER_LINEAR | cv::WARP_INVERSE_MAP,
+                   cv::BORDER_REPLICATE);
+    aligned_dark = warped_;
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef FRAME_REGISTRATION_H
+#define FRAME_REGISTRATION_H
+
+#include "frame_arena.h"
+#include <opencv2/opencv.hpp>
+
+/**
+ * @struct FrameRegistrationParams
+ * @brief 明暗帧配准的参数。
+ */
+struct FrameRegistrationParams {
+    double max_shift = 8.0;    ///< 允许的最大平移（像素），也是搜索半径
+    double min_response = 0.3; ///< 归一化互相关峰值的下限，低于该值时认为估计不可靠
+};
+
+/**
+ * @class FrameRegistration
+ * @brief 在眼睛区域内估计暗瞳帧相对明瞳帧的平移，并输出对齐后的暗瞳区域。
+ *
+ * 高帧率下眼睛在两次曝光之间仍会移动，直接 absdiff 会在瞳孔边缘留下月牙形
+ * 残差，产生多余的轮廓。这里只在给定的区域内，对两帧的梯度幅值图像做 ±max_shift
+ * 范围内的归一化互相关（与 cv::matchTemplate 的 TM_CCOEFF_NORMED 相同，相关项用
+ * cv::dft 计算），峰值处抛物线拟合得到亚像素平移，再用双线性插值只重采样该区域的
+ * 暗瞳图像，计算量与区域大小成正比。
+ *
+ * 不用灰度图像上的相位相关：瞳孔在两帧中亮暗相反，两帧的光斑来自不同光源、
+ * 相对瞳孔的位置不同，白化后的相关峰会锁定在光斑之间的偏移上。梯度幅值对亮暗
+ * 极性不敏感，瞳孔、虹膜和眼睑的边缘在两帧中一致；不白化时小面积的光斑权重很低。
+ *
+ * 实例持有复用的中间缓冲区，不能被多个线程同时调用。浮点图像、梯度、积分图、DFT
+ * 缓冲区和对齐结果都是 FrameArena 上的视图，跟踪时搜索区域尺寸逐帧变化也不重新分配；
+ * 遇到更大的区域时只在下一次调用时扩容一次。
+ */
+class FrameRegistration {
+public:
+    explicit FrameRegistration(const FrameRegistrationParams& params = FrameRegistrationParams());
+
+    /**
+     * @brief 估计区域内暗瞳帧相对明瞳帧的平移：dark(x) ≈ light(x - shift)。
+     * @param light_image 明瞳图像。
+     * @param dark_image 暗瞳图像，尺寸和类型与明瞳图像相同。
+     * @param roi 参与估计的区域（会被裁剪到图像范围内）。
+     * @param shift 输出的平移（像素）；估计不可靠时为 (0, 0)。
+     * @return 估计可靠时返回 true。
+     */
+    bool estimate(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Rect& roi, cv::Point2d& shift);
+
+    /**
+     * @brief 估计平移并输出与 light_image(roi) 对齐的暗瞳区域。
+     *
+     * 估计不可靠时 aligned_dark 为 dark_image(roi) 的图像头（不拷贝）；否则引用实例内部的
+     * 缓冲区，在下一次调用 align 或 estimate 之前有效。
+     *
+     * @param light_image 明瞳图像。
+     * @param dark_image 暗瞳图像。
+     * @param roi 区域，须位于图像范围内。
+     * @param aligned_dark 输出的暗瞳区域，尺寸为 roi.size()，类型与输入相同。
+     * @param shift 可选，输出采用的平移。
+     * @return 做了对齐时返回 true。
+     */
+    bool align(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Rect& roi, cv::Mat& aligned_dark,
+               cv::Point2d* shift = nullptr);
+
+    /**
+     * @brief 最近一次估计的归一化互相关峰值，范围 [-1, 1]。
+     */
+    double last_response() const { return response_; }
+
+private:
+    /**
+     * @brief 把图像区域转换为单通道浮点图像，结果从 arena_ 中切出。
+     */
+    cv::Mat to_float_gray(const cv::Mat& image);
+
+    /**
+     * @brief 原地模糊浮点图像后计算梯度幅值，结果从 arena_ 中切出。
+     */
+    cv::Mat gradient_magnitude(cv::Mat& image);
+
+    /**
+     * @brief 计算 templ 在 image 中所有位置的 TM_CCOEFF_NORMED 得分，写入 match_。
+     */
+    void match_template(const cv::Mat& image, const cv::Mat& templ);
+
+    FrameRegistrationParams params_;
+    // 逐帧复用的中间缓冲区都是 arena_ 上的视图，每次 estimate 时重置并重新切出
+    FrameArena arena_;
+    cv::Mat grad_x_, grad_y_, light_grad_, dark_grad_, match_;
+    cv::Mat sum_, sqsum_, dft_buffer_, image_spectrum_, templ_spectrum_;
+    cv::Mat warped_;
+    double response_ = 0.0;
+};
+
+#endif // FRAME_REGISTRATION_H
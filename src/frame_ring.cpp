@@ -0,0 +1,141 @@
+#include "frame_ring.h"
+#include <chrono>
+#include <thread>
+
+/**
+ * @brief 无锁等待时的退避：先让出时间片，多次仍未满足后短暂休眠。
+ */
+static void backoff(int& spins) {
+    if (++spins < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+FrameRing::FrameRing(size_t capacity, const cv::Size& frame_size, int frame_type, size_t max_held,
+                     double late_threshold_ms, bool drop_oldest)
+    : slots_((capacity == 0 ? 1 : capacity) + (max_held == 0 ? 1 : max_held) + 1),
+      ring_(capacity == 0 ? 1 : capacity),
+      head_(0),
+      tail_(0),
+      free_(slots_.size()),
+      free_head_(0),
+      free_tail_(0),
+      drop_oldest_(drop_oldest),
+      closed_(false),
+      published_(0),
+      dropped_(0),
+      late_(0) {
+    for (FrameSlot& slot : slots_) {
+        slot.frames[0].create(frame_size, frame_type);
+        slot.frames[1].create(frame_size, frame_type);
+        slot.mask.create(frame_size, CV_8UC1);
+    }
+    for (auto& entry : ring_) {
+        entry.store(0, std::memory_order_relaxed);
+    }
+
+    // 槽位 0 交给生产者，其余全部进入空闲队列
+    write_index_ = 0;
+    for (size_t i = 1; i < slots_.size(); ++i) {
+        free_[i - 1] = static_cast<uint32_t>(i);
+    }
+    free_head_.store(slots_.size() - 1, std::memory_order_relaxed);
+
+    if (late_threshold_ms > 0) {
+        late_threshold_ticks_ = static_cast<int64_t>(late_threshold_ms * cv::getTickFrequency() / 1000.0);
+    }
+}
+
+void FrameRing::publish() {
+    const uint64_t capacity = ring_.size();
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+
+    // 队列已满：与消费者竞争推进 tail_，成功者拿走最旧的槽位
+    bool reuse_dropped = false;
+    uint32_t dropped_index = 0;
+    int spins = 0;
+    while (true) {
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail < capacity) {
+            break;
+        }
+        if (!drop_oldest_) {
+            backoff(spins);
+            continue;
+        }
+        uint32_t victim = ring_[tail % capacity].load(std::memory_order_relaxed);
+        if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            dropped_index = victim;
+            reuse_dropped = true;
+            break;
+        }
+    }
+
+    slots_[write_index_].publish_tick = cv::getTickCount();
+    ring_[head % capacity].store(write_index_, std::memory_order_relaxed);
+    head_.store(head + 1, std::memory_order_release);
+    published_.fetch_add(1, std::memory_order_relaxed);
+
+    // 取得下一个写入槽位：优先复用刚丢弃的槽位，否则从空闲队列中取。
+    // 槽位总数保证此时空闲队列一定非空。
+    if (reuse_dropped) {
+        write_index_ = dropped_index;
+    } else {
+        // acquire 读取 free_head_ 与 release() 的 release 写配对，保证随后读到的 free_ 元素已写入；
+        // 该读取不能只放在 CV_DbgAssert 中，否则 Release 构建里没有同步
+        const uint64_t free_tail = free_tail_.load(std::memory_order_relaxed);
+        const uint64_t free_head = free_head_.load(std::memory_order_acquire);
+        CV_DbgAssert(free_tail != free_head);
+        (void)free_head;
+        write_index_ = free_[free_tail % free_.size()];
+        free_tail_.store(free_tail + 1, std::memory_order_release);
+    }
+}
+
+FrameSlot* FrameRing::try_acquire() {
+    const uint64_t capacity = ring_.size();
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    while (true) {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) {
+            return nullptr;
+        }
+        uint32_t index = ring_[tail % capacity].load(std::memory_order_relaxed);
+        // CAS 失败说明该槽位刚被生产者丢弃，tail 已被更新为最新值，重试即可
+        if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_acq_rel)) {
+            FrameSlot* slot = &slots_[index];
+            slot->late = late_threshold_ticks_ > 0 &&
+                         cv::getTickCount() - slot->publish_tick > late_threshold_ticks_;
+            if (slot->late) {
+                late_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return slot;
+        }
+    }
+}
+
+FrameSlot* FrameRing::acquire() {
+    int spins = 0;
+    while (true) {
+        // 先读取关闭标志，再检查队列，避免漏掉关闭前发布的最后几帧
+        const bool closed = closed_.load(std::memory_order_acquire);
+        FrameSlot* slot = try_acquire();
+        if (slot != nullptr) {
+            return slot;
+        }
+        if (closed) {
+            return nullptr;
+        }
+        backoff(spins);
+    }
+}
+
+void FrameRing::release(FrameSlot* slot) {
+    const uint32_t index = static_cast<uint32_t>(slot - slots_.data());
+    const uint64_t free_head = free_head_.load(std::memory_order_relaxed);
+    free_[free_head % free_.size()] = index;
+    free_head_.store(free_head + 1, std::memory_order_release);
+}
@@ -0,0 +1,121 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include "frame_pair.h"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct FrameSlot
+ * @brief 环形缓冲区中的一个预分配槽位，存放一个明暗帧对。
+ */
+struct FrameSlot {
+    cv::Mat frames[2];         ///< 按到达顺序写入的两帧，构造时预分配
+    cv::Mat mask;              ///< 处理线程写入的单通道 8 位结果（如二值差分图像），构造时预分配
+    FramePair pair;            ///< 指向 frames 的明暗帧对（由 FramePairDemuxer 填充）
+    int64_t publish_tick = 0;  ///< 发布时刻（cv::getTickCount）
+    bool late = false;         ///< 被取出时是否已超过延迟阈值
+};
+
+/**
+ * @class FrameRing
+ * @brief 采集线程与处理线程之间的无锁单生产者/单消费者帧环。
+ *
+ * 所有槽位在构造时按帧尺寸一次性分配，稳态运行时没有堆分配，内存占用固定。
+ * 默认策略下生产者从不阻塞：消费者跟不上时丢弃最旧的未处理帧对（drop-oldest），
+ * 保证处理的总是最新数据，适用于实时相机；离线处理录像时可关闭丢帧，
+ * 此时生产者在队列满时等待。
+ *
+ * 槽位数量为 capacity + max_held + 1：队列中最多 capacity 个待处理槽位，
+ * 消费者一侧最多同时持有 max_held 个槽位（流水线下游阶段仍在使用的帧），
+ * 生产者持有 1 个正在写入的槽位。消费者取出槽位后必须调用 release() 归还；
+ * release() 可以在另一个线程中调用，但同一时刻只能有一个线程调用它。
+ *
+ * 同时统计丢弃帧数和迟到帧数（取出时距发布已超过 late_threshold_ms）。
+ */
+class FrameRing {
+public:
+    /**
+     * @brief 构造帧环并预分配所有槽位。
+     * @param capacity 待处理队列的容量。
+     * @param frame_size 单帧尺寸。
+     * @param frame_type 单帧类型，默认 CV_8UC1。
+     * @param max_held 消费者一侧最多同时持有的槽位数。
+     * @param late_threshold_ms 迟到判定阈值（毫秒），小于等于 0 表示不统计迟到。
+     * @param drop_oldest 队列满时是否丢弃最旧的帧对；为 false 时生产者等待。
+     */
+    FrameRing(size_t capacity, const cv::Size& frame_size, int frame_type = CV_8UC1,
+              size_t max_held = 1, double late_threshold_ms = 0.0, bool drop_oldest = true);
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // --- 生产者接口（只能在采集线程中调用） ---
+
+    /**
+     * @brief 生产者当前可写入的槽位，发布前可以反复写入。
+     */
+    FrameSlot& write_slot() { return slots_[write_index_]; }
+
+    /**
+     * @brief 发布当前写入槽位；队列已满时丢弃最旧的一个（或在不丢帧模式下等待）。
+     */
+    void publish();
+
+    /**
+     * @brief 通知消费者不会再有新的帧。
+     */
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // --- 消费者接口 ---
+
+    /**
+     * @brief 尝试取出最旧的待处理槽位。
+     * @return 队列为空时返回 nullptr。
+     */
+    FrameSlot* try_acquire();
+
+    /**
+     * @brief 等待并取出最旧的待处理槽位（自旋后逐步退避）。
+     * @return 帧环已关闭且队列为空时返回 nullptr。
+     */
+    FrameSlot* acquire();
+
+    /**
+     * @brief 归还一个已取出的槽位，供生产者复用。
+     */
+    void release(FrameSlot* slot);
+
+    // --- 统计 ---
+
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t late() const { return late_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return ring_.size(); }
+
+private:
+    std::vector<FrameSlot> slots_;
+
+    // 待处理队列：存放槽位编号，head_ 只由生产者推进，tail_ 由消费者取出或生产者丢弃时 CAS 推进
+    std::vector<std::atomic<uint32_t>> ring_;
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<uint64_t> tail_;
+
+    // 空闲队列：消费者归还的槽位编号，free_head_ 由归还线程推进，free_tail_ 由生产者推进
+    std::vector<uint32_t> free_;
+    alignas(64) std::atomic<uint64_t> free_head_;
+    alignas(64) std::atomic<uint64_t> free_tail_;
+
+    uint32_t write_index_ = 0; // 生产者持有的槽位
+    int64_t late_threshold_ticks_ = 0;
+    bool drop_oldest_;
+
+    std::atomic<bool> closed_;
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> late_;
+};
+
+#endif // FRAME_RING_H
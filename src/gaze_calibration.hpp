@@ -3,6 +3,7 @@
 
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <stdexcept>
 
 /**
  * @class Matrix
@@ -115,7 +116,7 @@ public:
      * @brief 构造函数，可选择设置正则化参数。
      * @param lambda 正则化系数，用于防止过拟合。
      */
-    GazeCalibration(double lambda = 0.1) : lambda_(lambda) {}
+    GazeCalibration(double lambda = 0.1) : lambda_(lambda), coeffs_x_(3, 1), coeffs_y_(3, 1) {}
 
     /**
      * @brief 添加一个标定点。
@@ -0,0 +1,541 @@
+#include "gradient_intersect.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+// 默认细化窗口半径相对金字塔缩放倍数的倍数：粗层窗口和模糊都按比例缩小，
+// 粗极值与全分辨率极值之间可能相差两个缩放倍数以上
+static const int DEFAULT_REFINE_RADIUS_SCALES = 3;
+
+/**
+ * @brief 当前编译目标下一个浮点向量包含的元素个数。
+ */
+static int simd_lanes() {
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    return cv::VTraits<cv::v_float32>::vlanes();
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief 计算一个候选中心在给定像素范围内的点积平方和。
+ *
+ * 梯度平面和位移表的行末都补了零，循环按整向量读取，越界部分的贡献为 0。
+ *
+ * @param grad_x 归一化梯度 x 分量（行末补零）。
+ * @param grad_y 归一化梯度 y 分量（行末补零）。
+ * @param grid_x 单位位移 x 分量表。
+ * @param grid_y 单位位移 y 分量表。
+ * @param cx 候选中心 x。
+ * @param cy 候选中心 y。
+ * @param half_w 位移表的半宽（即 dx 的范围为 [-half_w, half_w)）。
+ * @param half_h 位移表的半高。
+ * @param x0 x 范围起点（含）。
+ * @param x1 x 范围终点（不含）。
+ * @param y0 y 范围起点（含）。
+ * @param y1 y 范围终点（不含）。
+ */
+static float score_candidate(const cv::Mat& grad_x, const cv::Mat& grad_y,
+                             const cv::Mat& grid_x, const cv::Mat& grid_y,
+                             int cx, int cy, int half_w, int half_h,
+                             int x0, int x1, int y0, int y1) {
+    const int count = x1 - x0;
+    if (count <= 0 || y1 <= y0) {
+        return 0.f;
+    }
+    const int grid_col = x0 - cx + half_w;
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const int padded = (count + lanes - 1) / lanes * lanes;
+    cv::v_float32 acc = cv::vx_setzero_f32();
+    for (int y = y0; y < y1; ++y) {
+        const float* gx = grad_x.ptr<float>(y) + x0;
+        const float* gy = grad_y.ptr<float>(y) + x0;
+        const float* dx = grid_x.ptr<float>(y - cy + half_h) + grid_col;
+        const float* dy = grid_y.ptr<float>(y - cy + half_h) + grid_col;
+        for (int i = 0; i < padded; i += lanes) {
+            cv::v_float32 dot = cv::v_fma(cv::vx_load(dx + i), cv::vx_load(gx + i),
+                                          cv::v_mul(cv::vx_load(dy + i), cv::vx_load(gy + i)));
+            acc = cv::v_fma(dot, dot, acc);
+        }
+    }
+    return cv::v_reduce_sum(acc);
+#else
+    float score = 0.f;
+    for (int y = y0; y < y1; ++y) {
+        const float* gx = grad_x.ptr<float>(y) + x0;
+        const float* gy = grad_y.ptr<float>(y) + x0;
+        const float* dx = grid_x.ptr<float>(y - cy + half_h) + grid_col;
+        const float* dy = grid_y.ptr<float>(y - cy + half_h) + grid_col;
+        for (int i = 0; i < count; ++i) {
+            float dot = dx[i] * gx[i] + dy[i] * gy[i];
+            score += dot * dot;
+        }
+    }
+    return score;
+#endif
+}
+
+/**
+ * @brief 稀疏模式下计算一个候选中心的得分。
+ *
+ * 对列表中的像素 p 直接计算 (d·g)^2 = ((p - c)·g)^2 / |p - c|^2，无需位移表。
+ * 列表按行序存放，[begin, end) 覆盖窗口内的所有行，列方向的窗口用掩码筛选；
+ * 读取越过 end 的项被行方向的掩码排除，越过列表末尾的补齐项梯度为 0。
+ *
+ * @param px 像素 x 坐标列表。
+ * @param py 像素 y 坐标列表。
+ * @param gx 归一化梯度 x 分量列表。
+ * @param gy 归一化梯度 y 分量列表。
+ * @param begin 窗口首行在列表中的起始下标。
+ * @param end 窗口末行之后在列表中的下标。
+ * @param cx 候选中心 x。
+ * @param cy 候选中心 y。
+ * @param half_w 窗口半宽，统计 dx ∈ [-half_w, half_w)。
+ * @param half_h 窗口半高，统计 dy ∈ [-half_h, half_h)。
+ */
+static float score_candidate_sparse(const float* px, const float* py,
+                                    const float* gx, const float* gy,
+                                    int begin, int end, int cx, int cy, int half_w, int half_h) {
+    const float fcx = static_cast<float>(cx);
+    const float fcy = static_cast<float>(cy);
+    const float x_lo = static_cast<float>(-half_w);
+    const float x_hi = static_cast<float>(half_w);
+    const float y_lo = static_cast<float>(-half_h);
+    const float y_hi = static_cast<float>(half_h);
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vcx = cv::vx_setall_f32(fcx), vcy = cv::vx_setall_f32(fcy);
+    const cv::v_float32 vx_lo = cv::vx_setall_f32(x_lo), vx_hi = cv::vx_setall_f32(x_hi);
+    const cv::v_float32 vy_lo = cv::vx_setall_f32(y_lo), vy_hi = cv::vx_setall_f32(y_hi);
+    const cv::v_float32 one = cv::vx_setall_f32(1.f), zero = cv::vx_setzero_f32();
+    cv::v_float32 acc = zero;
+    for (int i = begin; i < end; i += lanes) {
+        cv::v_float32 dx = cv::v_sub(cv::vx_load(px + i), vcx);
+        cv::v_float32 dy = cv::v_sub(cv::vx_load(py + i), vcy);
+        cv::v_float32 dot = cv::v_fma(dx, cv::vx_load(gx + i), cv::v_mul(dy, cv::vx_load(gy + i)));
+        // 位移为 0 时 dot 也为 0，分母取 max(|d|^2, 1) 即可避免除零
+        cv::v_float32 len2 = cv::v_max(cv::v_fma(dx, dx, cv::v_mul(dy, dy)), one);
+        cv::v_float32 term = cv::v_div(cv::v_mul(dot, dot), len2);
+        cv::v_float32 inside = cv::v_and(cv::v_and(cv::v_ge(dx, vx_lo), cv::v_lt(dx, vx_hi)),
+                                         cv::v_and(cv::v_ge(dy, vy_lo), cv::v_lt(dy, vy_hi)));
+        acc = cv::v_add(acc, cv::v_select(inside, term, zero));
+    }
+    return cv::v_reduce_sum(acc);
+#else
+    float score = 0.f;
+    for (int i = begin; i < end; ++i) {
+        const float dx = px[i] - fcx;
+        const float dy = py[i] - fcy;
+        if (dx < x_lo || dx >= x_hi || dy < y_lo || dy >= y_hi) {
+            continue;
+        }
+        const float dot = dx * gx[i] + dy * gy[i];
+        score += dot * dot / std::max(dx * dx + dy * dy, 1.f);
+    }
+    return score;
+#endif
+}
+
+void GradientIntersect::createGrid(int rows, int cols, int pad, cv::Mat& grid_x, cv::Mat& grid_y) {
+    grid_x.create(2 * rows, 2 * cols + pad, CV_32F);
+    grid_y.create(2 * rows, 2 * cols + pad, CV_32F);
+
+    for (int r = 0; r < grid_x.rows; r++) {
+        float* gx = grid_x.ptr<float>(r);
+        float* gy = grid_y.ptr<float>(r);
+        const int y = r - rows;
+        for (int c = 0; c < grid_x.cols; c++) {
+            const int x = c - cols;
+            float norm = std::sqrt(static_cast<float>(x * x + y * y));
+            // 窗口之外（补齐部分）以及位移为 0 的位置贡献为 0
+            if (x >= cols || norm == 0) {
+                gx[c] = gy[c] = 0.f;
+            } else {
+                gx[c] = x / norm;
+                gy[c] = y / norm;
+            }
+        }
+    }
+}
+
+std::shared_ptr<const GradientIntersect::DisplacementGrid>
+GradientIntersect::sharedGrid(int rows, int cols, int pad) {
+    // 整 ROI 模式下表的尺寸随 ROI 变化，缓存条目数超过上限时清掉不再被使用的表
+    static const size_t MAX_CACHED_GRIDS = 16;
+    static std::mutex mutex;
+    static std::map<std::tuple<int, int, int>, std::shared_ptr<const DisplacementGrid>> cache;
+
+    const std::tuple<int, int, int> key(rows, cols, pad);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    if (cache.size() >= MAX_CACHED_GRIDS) {
+        for (auto entry = cache.begin(); entry != cache.end();) {
+            entry = entry->second.use_count() == 1 ? cache.erase(entry) : std::next(entry);
+        }
+    }
+    auto grid = std::make_shared<DisplacementGrid>();
+    createGrid(rows, cols, pad, grid->x, grid->y);
+    cache.emplace(key, grid);
+    return grid;
+}
+
+void GradientIntersect::normalizeImage(const cv::Mat& image) {
+    // 新的一帧：上一帧的视图全部作废
+    arena_.reset();
+    float_image_ = arena_.mat(image.size(), CV_32F);
+    image.convertTo(float_image_, CV_32F);
+    cv::normalize(float_image_, float_image_, 0, 1, cv::NORM_MINMAX);
+}
+
+void GradientIntersect::createGradient(const cv::Mat& float_image, int pad) {
+    const cv::Size padded_size(float_image.cols + pad, float_image.rows);
+    grad_x_ = arena_.mat(padded_size, CV_32F);
+    grad_y_ = arena_.mat(padded_size, CV_32F);
+    magnitude_ = arena_.mat(float_image.size(), CV_32F);
+    if (pad > 0) {
+        // 视图内容未初始化，补齐列每帧清零（有效区域由 Sobel 写满）
+        grad_x_.colRange(float_image.cols, padded_size.width).setTo(0);
+        grad_y_.colRange(float_image.cols, padded_size.width).setTo(0);
+    }
+    const cv::Rect valid(0, 0, float_image.cols, float_image.rows);
+    cv::Mat grad_x = grad_x_(valid);
+    cv::Mat grad_y = grad_y_(valid);
+    cv::Sobel(float_image, grad_x, CV_32F, 1, 0);
+    cv::Sobel(float_image, grad_y, CV_32F, 0, 1);
+
+    // 归一化为单位向量；梯度为 0 的位置保持为 0
+    cv::magnitude(grad_x, grad_y, magnitude_);
+    cv::max(magnitude_, FLT_MIN, magnitude_);
+    cv::divide(grad_x, magnitude_, grad_x);
+    cv::divide(grad_y, magnitude_, grad_y);
+}
+
+void GradientIntersect::collectStrongGradients(double k, int pad) {
+    const int rows = float_image_.rows;
+    const int cols = float_image_.cols;
+    const cv::Rect valid(0, 0, cols, rows);
+
+    // magnitude_ 中保存的是归一化之前的梯度模长
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(magnitude_, mean, stddev);
+    const float threshold = static_cast<float>(mean[0] + k * stddev[0]);
+
+    points_x_.clear();
+    points_y_.clear();
+    points_gx_.clear();
+    points_gy_.clear();
+    row_start_.resize(rows + 1);
+    for (int y = 0; y < rows; ++y) {
+        row_start_[y] = static_cast<int>(points_x_.size());
+        const float* mag = magnitude_.ptr<float>(y);
+        const float* gx = grad_x_(valid).ptr<float>(y);
+        const float* gy = grad_y_(valid).ptr<float>(y);
+        for (int x = 0; x < cols; ++x) {
+            if (mag[x] > threshold) {
+                points_x_.push_back(static_cast<float>(x));
+                points_y_.push_back(static_cast<float>(y));
+                points_gx_.push_back(gx[x]);
+                points_gy_.push_back(gy[x]);
+            }
+        }
+    }
+    row_start_[rows] = static_cast<int>(points_x_.size());
+
+    // 补齐项梯度为 0，向量化循环越过末尾读取时贡献为 0
+    points_x_.resize(points_x_.size() + pad, 0.f);
+    points_y_.resize(points_y_.size() + pad, 0.f);
+    points_gx_.resize(points_gx_.size() + pad, 0.f);
+    points_gy_.resize(points_gy_.size() + pad, 0.f);
+}
+
+void GradientIntersect::prepare(const cv::Mat& image, const GradientIntersectParams& params) {
+    const int pad = simd_lanes() - 1;
+
+    normalizeImage(image);
+    blurred_ = arena_.mat(image.size(), CV_32F);
+    cv::GaussianBlur(float_image_, blurred_, cv::Size(0, 0), params.sigma);
+    createGradient(float_image_, pad);
+
+    // 位移表只需覆盖统计窗口，整 ROI 模式下覆盖所有可能的位移
+    half_h_ = params.window > 0 ? params.window : image.rows;
+    half_w_ = params.window > 0 ? params.window : image.cols;
+    sparse_ = params.sparse && params.engine == GRADIENT_ENGINE_DIRECT;
+    if (sparse_) {
+        collectStrongGradients(params.sparse_k, pad);
+    } else {
+        grid_ = sharedGrid(half_h_, half_w_, pad);
+    }
+}
+
+float GradientIntersect::scoreAt(int cx, int cy) const {
+    const int rows = float_image_.rows;
+    const int cols = float_image_.cols;
+    const int y0 = std::max(0, cy - half_h_);
+    const int y1 = std::min(rows, cy + half_h_);
+    float score;
+    if (sparse_) {
+        score = score_candidate_sparse(points_x_.data(), points_y_.data(),
+                                       points_gx_.data(), points_gy_.data(),
+                                       row_start_[y0], row_start_[y1],
+                                       cx, cy, half_w_, half_h_);
+    } else {
+        const int x0 = std::max(0, cx - half_w_);
+        const int x1 = std::min(cols, cx + half_w_);
+        score = score_candidate(grad_x_, grad_y_, grid_->x, grid_->y,
+                                cx, cy, half_w_, half_h_, x0, x1, y0, y1);
+    }
+    return score * (1 - blurred_.at<float>(cy, cx));
+}
+
+void GradientIntersect::scoreMapFFT(const cv::Rect& candidates) {
+    const int rows = float_image_.rows;
+    const int cols = float_image_.cols;
+    // 补零后的尺寸要能容纳图像加上整个窗口，避免循环相关的回绕
+    const cv::Size dft_size(cv::getOptimalDFTSize(cols + 2 * half_w_),
+                            cv::getOptimalDFTSize(rows + 2 * half_h_));
+
+    // 实数 DFT 的 CCS 打包频谱和实数逆变换的结果都与输入同尺寸、同类型
+    fft_buffer_ = arena_.mat(dft_size, CV_32F);
+    fft_spectrum_ = arena_.mat(dft_size, CV_32F);
+    fft_accum_ = arena_.mat(dft_size, CV_32F);
+    fft_result_ = arena_.mat(dft_size, CV_32F);
+
+    // 核 K(t) 的第 (r, c) 项对应位移 dy = r - half_h_、dx = c - half_w_，
+    // 交叉项的系数 2 直接乘进核里
+    if (kernel_dft_size_ != dft_size || kernel_half_w_ != half_w_ || kernel_half_h_ != half_h_) {
+        const cv::Rect window(0, 0, 2 * half_w_, 2 * half_h_);
+        const cv::Mat dx = grid_->x(window);
+        const cv::Mat dy = grid_->y(window);
+        cv::Mat kernels[3];
+        cv::multiply(dx, dx, kernels[0]);
+        cv::multiply(dx, dy, kernels[1], 2.0);
+        cv::multiply(dy, dy, kernels[2]);
+        for (int i = 0; i < 3; ++i) {
+            fft_buffer_.setTo(0);
+            kernels[i].copyTo(fft_buffer_(window));
+            cv::dft(fft_buffer_, kernel_spectra_[i], 0, window.height);
+        }
+        kernel_dft_size_ = dft_size;
+        kernel_half_w_ = half_w_;
+        kernel_half_h_ = half_h_;
+    }
+
+    // 梯度分量乘积 A(p)，与核做相关：R(s) = sum_t K(t) A(t + s)
+    const cv::Rect valid(0, 0, cols, rows);
+    const cv::Mat gx = grad_x_(valid);
+    const cv::Mat gy = grad_y_(valid);
+    for (int i = 0; i < 3; ++i) {
+        fft_buffer_.setTo(0);
+        cv::Mat product = fft_buffer_(valid);
+        cv::multiply(i == 2 ? gy : gx, i == 0 ? gx : gy, product);
+        cv::dft(fft_buffer_, fft_spectrum_, 0, rows);
+        if (i == 0) {
+            cv::mulSpectrums(fft_spectrum_, kernel_spectra_[i], fft_accum_, 0, true);
+        } else {
+            cv::mulSpectrums(fft_spectrum_, kernel_spectra_[i], fft_spectrum_, 0, true);
+            cv::add(fft_accum_, fft_spectrum_, fft_accum_);
+        }
+    }
+    cv::idft(fft_accum_, fft_result_, cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+
+    // 候选中心 c 的得分位于 s = c - (half_w_, half_h_)，负偏移回绕到末尾
+    for (int cy = candidates.y; cy < candidates.y + candidates.height; ++cy) {
+        const int sy = (cy - half_h_ + dft_size.height) % dft_size.height;
+        const float* corr_row = fft_result_.ptr<float>(sy);
+        const float* blur_row = blurred_.ptr<float>(cy);
+        float* score_row = scores_.ptr<float>(cy);
+        for (int cx = candidates.x; cx < candidates.x + candidates.width; ++cx) {
+            const int sx = (cx - half_w_ + dft_size.width) % dft_size.width;
+            score_row[cx] = corr_row[sx] * (1 - blur_row[cx]);
+        }
+    }
+}
+
+cv::Point GradientIntersect::locate(const cv::Mat& image, double sigma, int accuracy) {
+    GradientIntersectParams params;
+    params.sigma = sigma;
+    params.accuracy = accuracy;
+    return locate(image, params);
+}
+
+cv::Point GradientIntersect::locate(const cv::Mat& image, const GradientIntersectParams& params) {
+    if (image.empty()) {
+        return cv::Point(-1, -1);
+    }
+    const int rows = image.rows;
+    const int cols = image.cols;
+    const int accuracy = std::max(1, params.accuracy);
+
+    prepare(image, params);
+
+    // 限制搜索范围到中心区域
+    const int border = std::max(0, params.border);
+    const int start_y = border;
+    const int end_y = rows - border;
+    const int start_x = border;
+    const int end_x = cols - border;
+
+    scores_ = arena_.mat(image.size(), CV_32F);
+    scores_.setTo(0);
+    if (start_y >= end_y || start_x >= end_x) {
+        return cv::Point(-1, -1);
+    }
+
+    if (params.engine == GRADIENT_ENGINE_FFT) {
+        scoreMapFFT(cv::Rect(start_x, start_y, end_x - start_x, end_y - start_y));
+    } else {
+        const int candidate_rows = (end_y - start_y + accuracy - 1) / accuracy;
+        cv::parallel_for_(cv::Range(0, candidate_rows), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; ++i) {
+                const int cy = start_y + i * accuracy;
+                float* score_row = scores_.ptr<float>(cy);
+                for (int cx = start_x; cx < end_x; cx += accuracy) {
+                    score_row[cx] = scoreAt(cx, cy);
+                }
+            }
+        });
+    }
+
+    cv::Point max_loc;
+    cv::minMaxLoc(scores_, nullptr, nullptr, nullptr, &max_loc);
+    return max_loc;
+}
+
+/**
+ * @brief 三点抛物线拟合的极值偏移量。
+ * @param left 左侧（-1 处）得分。
+ * @param center 中心得分。
+ * @param right 右侧（+1 处）得分。
+ * @return 极值相对中心的偏移，限制在 [-0.5, 0.5]；曲面不是凸的则返回 0。
+ */
+static float parabola_offset(float left, float center, float right) {
+    const float denom = left - 2 * center + right;
+    if (denom >= 0) {
+        return 0.f;
+    }
+    const float offset = 0.5f * (left - right) / denom;
+    return std::max(-0.5f, std::min(0.5f, offset));
+}
+
+cv::Point2f GradientIntersect::locateRefined(const cv::Mat& image, const GradientIntersectParams& params) {
+    if (image.empty()) {
+        return cv::Point2f(-1.f, -1.f);
+    }
+    const int levels = std::max(0, params.pyramid_levels);
+    const int scale = 1 << levels;
+    const int border = std::max(0, params.border);
+
+    // 在缩小的金字塔层上对所有候选求得分，窗口、边界和模糊尺度按比例缩小
+    pyramid_arena_.reset();
+    pyramid_ = image;
+    for (int level = 0; level < levels; ++level) {
+        cv::Mat next = pyramid_arena_.mat((pyramid_.rows + 1) / 2, (pyramid_.cols + 1) / 2, pyramid_.type());
+        cv::pyrDown(pyramid_, next);
+        pyramid_ = next;
+    }
+    GradientIntersectParams coarse_params = params;
+    coarse_params.accuracy = 1;
+    coarse_params.sigma = params.sigma / scale;
+    coarse_params.border = (border + scale - 1) / scale;
+    if (params.window > 0) {
+        coarse_params.window = std::max(1, (params.window + scale - 1) / scale);
+    }
+
+    std::vector<std::pair<float, cv::Point>>& peaks = peaks_;
+    peaks.clear();
+    if (levels > 0 && locate(pyramid_, coarse_params).x >= 0) {
+        // 收集 3x3 邻域内的局部极大值
+        for (int y = 1; y < scores_.rows - 1; ++y) {
+            const float* prev = scores_.ptr<float>(y - 1);
+            const float* row = scores_.ptr<float>(y);
+            const float* next = scores_.ptr<float>(y + 1);
+            for (int x = 1; x < scores_.cols - 1; ++x) {
+                const float v = row[x];
+                if (v > 0 && v >= row[x - 1] && v >= row[x + 1] &&
+                    v >= prev[x - 1] && v >= prev[x] && v >= prev[x + 1] &&
+                    v >= next[x - 1] && v >= next[x] && v >= next[x + 1]) {
+                    peaks.emplace_back(v, cv::Point(x * scale, y * scale));
+                }
+            }
+        }
+        const size_t top_k = std::min(peaks.size(), static_cast<size_t>(std::max(1, params.top_k)));
+        std::partial_sort(peaks.begin(), peaks.begin() + top_k, peaks.end(),
+                          [](const std::pair<float, cv::Point>& a, const std::pair<float, cv::Point>& b) {
+                              return a.first > b.first;
+                          });
+        peaks.resize(top_k);
+    }
+    if (peaks.empty()) {
+        // 图像太小无法建立金字塔或粗搜索失败时，退化为全分辨率搜索
+        cv::Point center = locate(image, params);
+        if (center.x < 0) {
+            return cv::Point2f(-1.f, -1.f);
+        }
+        peaks.emplace_back(0.f, center);
+    }
+
+    // 回到全分辨率，只在每个粗极值附近的小窗口内求得分
+    prepare(image, params);
+    const int radius = params.refine_radius > 0 ? params.refine_radius : DEFAULT_REFINE_RADIUS_SCALES * scale;
+    const int start_x = border, end_x = image.cols - border;
+    const int start_y = border, end_y = image.rows - border;
+    if (start_x >= end_x || start_y >= end_y) {
+        return cv::Point2f(-1.f, -1.f);
+    }
+    float best_score = -1.f;
+    cv::Point best(-1, -1);
+    for (const auto& peak : peaks) {
+        const int x0 = std::max(start_x, peak.second.x - radius);
+        const int x1 = std::min(end_x, peak.second.x + radius + 1);
+        const int y0 = std::max(start_y, peak.second.y - radius);
+        const int y1 = std::min(end_y, peak.second.y + radius + 1);
+        for (int cy = y0; cy < y1; ++cy) {
+            for (int cx = x0; cx < x1; ++cx) {
+                const float score = scoreAt(cx, cy);
+                if (score > best_score) {
+                    best_score = score;
+                    best = cv::Point(cx, cy);
+                }
+            }
+        }
+    }
+    if (best.x < 0) {
+        return cv::Point2f(-1.f, -1.f);
+    }
+
+    // 对得分曲面在 x、y 方向分别做抛物线拟合，得到亚像素位置
+    cv::Point2f refined(static_cast<float>(best.x), static_cast<float>(best.y));
+    if (best.x > 0 && best.x < image.cols - 1) {
+        refined.x += parabola_offset(scoreAt(best.x - 1, best.y), best_score, scoreAt(best.x + 1, best.y));
+    }
+    if (best.y > 0 && best.y < image.rows - 1) {
+        refined.y += parabola_offset(scoreAt(best.x, best.y - 1), best_score, scoreAt(best.x, best.y + 1));
+    }
+    return refined;
+}
+
+cv::Mat GradientIntersect::getGradientImage(const cv::Mat& image) {
+    normalizeImage(image);
+    createGradient(float_image_, 0);
+
+    // 归一化梯度的模长为 1（有梯度）或 0（无梯度）
+    const cv::Rect valid(0, 0, image.cols, image.rows);
+    cv::Mat magnitude;
+    cv::magnitude(grad_x_(valid), grad_y_(valid), magnitude);
+    cv::Mat gradient_vis;
+    magnitude.convertTo(gradient_vis, CV_8U, 255);
+    return gradient_vis;
+}
@@ -0,0 +1,184 @@
+#ifndef GRADIENT_INTERSECT_H
+#define GRADIENT_INTERSECT_H
+
+#include "frame_arena.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 梯度相交得分的计算方式。
+ */
+enum GradientEngine {
+    GRADIENT_ENGINE_DIRECT = 0, ///< 逐候选直接累加（向量化），适合小窗口
+    GRADIENT_ENGINE_FFT         ///< 展开为三个相关运算，用 DFT 一次得到整张得分图，适合大窗口或整 ROI
+};
+
+/**
+ * @struct GradientIntersectParams
+ * @brief 梯度相交法瞳孔中心定位的参数。
+ */
+struct GradientIntersectParams {
+    double sigma = 2.0;  ///< 计算暗度权重 (1 - 模糊灰度) 时的高斯模糊标准差
+    int accuracy = 1;    ///< 候选中心的采样步长（像素）
+    int window = 15;     ///< 每个候选中心只统计 [-window, window) 邻域内的梯度；<= 0 表示统计整个 ROI
+    int border = 5;      ///< 候选中心距离 ROI 边缘的最小距离
+    bool sparse = false; ///< 稀疏模式：只统计梯度模长超过阈值的像素
+    double sparse_k = 0.3; ///< 稀疏模式的阈值系数，阈值为 mean + sparse_k * stddev（梯度模长）
+    int pyramid_levels = 2; ///< locateRefined 粗搜索所在的金字塔层数，每层缩小一半（2 即 1/4 尺度）
+    int top_k = 3;          ///< locateRefined 在全分辨率下细化的粗极值个数
+    int refine_radius = 0;  ///< 细化窗口半径（全分辨率像素）；<= 0 表示取金字塔缩放倍数的 3 倍
+    GradientEngine engine = GRADIENT_ENGINE_DIRECT; ///< locate 使用的得分计算方式
+};
+
+/**
+ * @class GradientIntersect
+ * @brief 基于梯度相交（means of gradients）的瞳孔中心定位。
+ *
+ * 对每个候选中心 c，统计其邻域内所有像素 p 的归一化梯度 g 与单位位移
+ * d = (p - c) / |p - c| 的点积平方和 sum((d·g)^2)，再乘以暗度权重
+ * (1 - 模糊灰度)，得分最高的候选即为瞳孔中心。
+ *
+ * 梯度和位移表都以结构数组（SoA）形式存放为独立的 x/y 浮点平面，行内连续，
+ * 点积平方累加使用 OpenCV 通用向量指令（universal intrinsics），
+ * 以编译器允许的最宽向量执行（SSE/AVX2/NEON，取决于编译选项，
+ * 例如 MSVC 的 /arch:AVX2 或 GCC 的 -mavx2）。候选中心按行用
+ * cv::parallel_for_ 并行。
+ *
+ * FFT 模式下利用 (d·g)^2 = dx^2·gx^2 + 2·dx·dy·gx·gy + dy^2·gy^2，
+ * 把得分图写成 gx^2、gx·gy、gy^2 三张图与固定位移核的相关之和，用 cv::dft
+ * 一次算出，整 ROI 统计时复杂度为 O(N log N)。该模式忽略 accuracy 和 sparse。
+ *
+ * 稀疏模式（GradientIntersectParams::sparse）下先筛出梯度模长较大的像素，
+ * 候选中心只与这些像素计算得分，计算量随入选像素的比例成比例下降。
+ *
+ * 实例持有逐帧复用的中间缓冲区，不能被多个线程同时调用。浮点图像、梯度、得分图和
+ * DFT 缓冲区都是 FrameArena 上的视图，ROI 尺寸逐帧变化时也不重新分配；
+ * 遇到更大的 ROI 时只在下一帧扩容一次。
+ */
+class GradientIntersect {
+public:
+    /**
+     * @brief 定位瞳孔中心。
+     * @param image 灰度眼睛区域图像（CV_8UC1 或 CV_32FC1）。
+     * @param sigma 暗度权重的高斯模糊标准差。
+     * @param accuracy 候选中心的采样步长。
+     * @return 瞳孔中心在 image 中的坐标。
+     */
+    cv::Point locate(const cv::Mat& image, double sigma = 2, int accuracy = 1);
+
+    /**
+     * @brief 使用完整参数定位瞳孔中心。
+     */
+    cv::Point locate(const cv::Mat& image, const GradientIntersectParams& params);
+
+    /**
+     * @brief 由粗到精定位瞳孔中心，返回亚像素坐标。
+     *
+     * 先在 1/2^pyramid_levels 尺度上对所有候选求得分，取得分最高的 top_k 个
+     * 局部极大值，再在全分辨率下只对这些极值附近 refine_radius 范围内的候选
+     * 求得分，最后对最高分位置的得分曲面做抛物线拟合。计算量主要取决于
+     * 粗层的候选数，对 ROI 尺寸不敏感。忽略 params.accuracy。
+     *
+     * @param image 灰度眼睛区域图像。
+     * @param params 定位参数。
+     * @return 亚像素精度的瞳孔中心；失败返回 (-1, -1)。
+     */
+    cv::Point2f locateRefined(const cv::Mat& image, const GradientIntersectParams& params = GradientIntersectParams());
+
+    /**
+     * @brief 最近一次 locate 的得分图（与输入同尺寸的 CV_32F 视图），下一次调用前有效。
+     */
+    const cv::Mat& scores() const { return scores_; }
+
+    /**
+     * @brief 最近一次稀疏模式定位入选的强梯度像素数；非稀疏模式返回 0。
+     */
+    int sparsePointCount() const { return sparse_ && !row_start_.empty() ? row_start_.back() : 0; }
+
+    /**
+     * @brief 计算归一化梯度的可视化图像（梯度存在处为 255）。
+     */
+    cv::Mat getGradientImage(const cv::Mat& image);
+
+private:
+    /**
+     * @brief 创建单位位移表 d = (dx, dy) / |(dx, dy)|。
+     *
+     * 表的第 r 行、第 c 列对应位移 dy = r - rows、dx = c - cols，覆盖
+     * dy ∈ [-rows, rows)、dx ∈ [-cols, cols)。每行末尾额外补 pad 个零，
+     * 使向量化循环可以整块读取而无需处理尾部。
+     */
+    static void createGrid(int rows, int cols, int pad, cv::Mat& grid_x, cv::Mat& grid_y);
+
+    /**
+     * @brief 单位位移表的 x/y 分量，创建后只读。
+     */
+    struct DisplacementGrid {
+        cv::Mat x, y;
+    };
+
+    /**
+     * @brief 获取指定尺寸的单位位移表，按 (rows, cols, pad) 在所有实例间共享缓存。
+     *
+     * 线程安全。表只依赖统计窗口尺寸，固定窗口下所有帧、左右眼共用同一张表。
+     */
+    static std::shared_ptr<const DisplacementGrid> sharedGrid(int rows, int cols, int pad);
+
+    /**
+     * @brief 归一化并计算梯度，结果写入 grad_x_ / grad_y_（每行末尾补 pad 个零）。
+     * grad_x_、grad_y_ 和 magnitude_ 从 arena_ 中切出，需先调用 normalizeImage。
+     */
+    void createGradient(const cv::Mat& float_image, int pad);
+
+    /**
+     * @brief 重置 arena_ 并将输入转换为 [0, 1] 范围的浮点图像，结果存放在 float_image_。
+     */
+    void normalizeImage(const cv::Mat& image);
+
+    /**
+     * @brief 为 image 准备梯度、暗度权重以及位移表（或稀疏列表），供 scoreAt 使用。
+     */
+    void prepare(const cv::Mat& image, const GradientIntersectParams& params);
+
+    /**
+     * @brief 计算候选中心 (cx, cy) 的加权得分，需先调用 prepare。可被多个线程同时调用。
+     */
+    float scoreAt(int cx, int cy) const;
+
+    /**
+     * @brief 用 DFT 计算 candidates 区域内所有候选的加权得分，写入 scores_，需先调用 prepare。
+     */
+    void scoreMapFFT(const cv::Rect& candidates);
+
+    /**
+     * @brief 收集梯度模长超过 mean + k * stddev 的像素，按行序存入紧凑列表。
+     *
+     * 列表以 SoA 形式存放坐标和归一化梯度，末尾补齐一个向量宽度的零梯度项；
+     * row_start_[y] 为第 y 行第一个像素在列表中的下标。
+     */
+    void collectStrongGradients(double k, int pad);
+
+    // 逐帧复用的中间缓冲区：除 pyramid_ 外都是 arena_ 上的视图，每次 prepare 时重新切出；
+    // 金字塔各层取自 pyramid_arena_，粗层上的 prepare 不会覆盖它们
+    FrameArena arena_, pyramid_arena_;
+    cv::Mat float_image_, blurred_, scores_;
+    cv::Mat grad_x_, grad_y_, magnitude_;
+    cv::Mat pyramid_;
+    std::vector<std::pair<float, cv::Point>> peaks_; // locateRefined 的粗层极值
+    std::shared_ptr<const DisplacementGrid> grid_; // 当前使用的位移表（来自共享缓存）
+    int half_w_ = 0, half_h_ = 0; // 当前统计窗口的半宽、半高
+    bool sparse_ = false;         // 当前是否为稀疏模式
+
+    // FFT 模式：位移核的频谱只依赖窗口和 DFT 尺寸，跨帧复用；其余 DFT 缓冲区取自 arena_
+    cv::Mat kernel_spectra_[3], fft_buffer_, fft_spectrum_, fft_accum_, fft_result_;
+    cv::Size kernel_dft_size_;
+    int kernel_half_w_ = 0, kernel_half_h_ = 0;
+
+    // 稀疏模式下的强梯度像素列表
+    std::vector<float> points_x_, points_y_, points_gx_, points_gy_;
+    std::vector<int> row_start_;
+};
+
+#endif // GRADIENT_INTERSECT_H
@@ -1,7 +1,103 @@
+#include "batch.h"
 #include "detection.h"
+#include "pipeline.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
-int main() {
+/**
+ * @brief 处理明暗光源逐帧交替的红外视频，逐对输出瞳孔中心与光斑中心。
+ *
+ * 解码、差分、拟合、光斑检测和视线映射在 TrackingPipeline 中并行流水执行。
+ * 输出文件每行依次为：帧对序号、明瞳帧时间戳、瞳孔中心 x y、光斑中心 x y，
+ * 未检测到时坐标为 -1。
+ *
+ * @param video_path 视频文件路径或流地址。
+ * @param output_file 保存结果的文本文件路径。
+ * @return 成功返回 0。
+ */
+static int process_video(const std::string& video_path, const std::string& output_file) {
+    std::ofstream outfile(output_file);
+    if (!outfile.is_open()) {
+        std::cerr << "Error: Could not open output file " << output_file << std::endl;
+        return -1;
+    }
+
+    // 网络流按实时模式处理（跟不上时丢弃最旧的帧对），本地文件逐帧处理不丢帧
+    PipelineConfig config;
+    config.realtime = video_path.find("://") != std::string::npos;
+
+    TrackingPipeline pipeline(nullptr, config);
+    bool ok = pipeline.run(video_path, [&outfile](const TrackingResult& result) {
+        outfile << result.index << " " << result.timestamp << " "
+                << result.pupil.center.x << " " << result.pupil.center.y << " "
+                << result.reflection.center.x << " " << result.reflection.center.y << std::endl;
+    });
+    if (!ok) {
+        return -1;
+    }
+
+    const PipelineStats& stats = pipeline.stats();
+    std::cout << "Processed " << stats.pairs << " pairs in " << stats.elapsed_sec << " s ("
+              << stats.pairs_per_second() << " pairs/s), dropped " << stats.dropped_pairs
+              << ", late " << stats.late_pairs << std::endl;
+    return 0;
+}
+
+/**
+ * @brief 并行处理目录或清单中的全部明暗图像对，结果写入一个 CSV 文件。
+ *
+ * @param source 图像目录或清单文件，格式见 list_batch_pairs。
+ * @param output_file 保存结果的 CSV 文件路径。
+ * @param threads 工作线程数，0 表示使用全部硬件线程。
+ * @return 成功返回 0。
+ */
+static int process_batch(const std::string& source, const std::string& output_file, size_t threads) {
+    std::vector<BatchPair> pairs;
+    if (!list_batch_pairs(source, pairs)) {
+        return -1;
+    }
+
+    BatchConfig config;
+    config.threads = threads;
+    BatchRunner runner(config);
+    std::vector<BatchRecord> records;
+    if (!runner.run(pairs, records) || !write_batch_csv(output_file, pairs, records)) {
+        return -1;
+    }
+
+    const BatchStats& stats = runner.stats();
+    std::cout << "Processed " << stats.pairs << " pairs on " << stats.threads << " threads in "
+              << stats.elapsed_sec << " s (" << stats.pairs_per_second() << " pairs/s), failed "
+              << stats.failed << ", steals " << stats.steals << std::endl;
+    const long ambiguous = std::count_if(records.begin(), records.end(),
+                                         [](const BatchRecord& record) { return record.order_ambiguous; });
+    if (ambiguous > 0) {
+        std::cout << ambiguous << " pairs kept the listed light/dark order (brightness too close to decide), "
+                  << "see order_ambiguous in " << output_file << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief 运行一种处理模式。
+ */
+static int run(int argc, char** argv) {
+    // --- 批处理输入 ---
+    // tracking --batch <目录或清单> [输出 CSV] [线程数]
+    if (argc > 2 && std::string(argv[1]) == "--batch") {
+        const std::string output_file = argc > 3 ? argv[3] : "output/batch_results.csv";
+        const size_t threads = argc > 4 ? static_cast<size_t>(std::max(0, std::atoi(argv[4]))) : 0;
+        return process_batch(argv[2], output_file, threads);
+    }
+
+    // --- 视频输入 ---
+    // 传入视频路径时，按明暗交替的视频逐对处理
+    if (argc > 1) {
+        return process_video(argv[1], "output/video_centers.txt");
+    }
+
     // --- 瞳孔检测输入与输出 ---
     // 使用明暗瞳法进行瞳孔检测，需要两张图像
     std::string pupil_light_image = "input/2.bmp";  // 明瞳图像（瞳孔亮）
@@ -22,3 +118,24 @@ int main() {
 
     return 0;
 }
+
+int main(int argc, char** argv) {
+    // --- 耗时跟踪 ---
+    // tracking --trace <trace.json> [其余参数]：记录各处理步骤的耗时，结束后导出 Chrome trace JSON
+    std::string trace_file;
+    if (argc > 2 && std::string(argv[1]) == "--trace") {
+        trace_file = argv[2];
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+        trace_set_enabled(true);
+    }
+
+    const int status = run(argc, argv);
+
+    if (!trace_file.empty()) {
+        trace_set_enabled(false);
+        trace_write_chrome_json(trace_file);
+    }
+    return status;
+}
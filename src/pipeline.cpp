@@ -0,0 +1,197 @@
+#include "pipeline.h"
+#include "frame_pair.h"
+#include "frame_ring.h"
+#include "trace.h"
+#include "video_source.h"
+#include <iostream>
+#include <thread>
+
+/**
+ * @struct PipelineItem
+ * @brief 在相邻阶段之间传递的工作项。
+ */
+struct PipelineItem {
+    FrameSlot* slot = nullptr; ///< 帧对所在的帧环槽位，光斑检测完成后归还
+    FramePair pair;        ///< 引用帧环槽位的明暗帧对
+    cv::Mat mask;          ///< 差分阶段输出的二值图像（引用槽位中预分配的 mask）
+    TrackingResult result; ///< 逐阶段填充的结果
+};
+
+TrackingPipeline::TrackingPipeline(const GazeCalibration* calibration, const PipelineConfig& config)
+    : calibration_(calibration),
+      config_(config),
+      reflection_detector_(config.eye_cascade_path),
+      pairs_done_(0) {
+    if (config_.queue_capacity == 0) {
+        config_.queue_capacity = 1;
+    }
+    for (auto& ticks : stage_ticks_) {
+        ticks = 0;
+    }
+}
+
+void TrackingPipeline::add_stage_time(PipelineStage stage, int64_t ticks) {
+    stage_ticks_[stage].fetch_add(ticks, std::memory_order_relaxed);
+}
+
+bool TrackingPipeline::run(const std::string& video_path, const ResultCallback& on_result) {
+    stats_ = PipelineStats();
+    for (auto& ticks : stage_ticks_) {
+        ticks = 0;
+    }
+    pairs_done_ = 0;
+
+    if (!reflection_detector_.is_loaded()) {
+        return false;
+    }
+    VideoFrameSource source;
+    if (!source.open(video_path)) {
+        return false;
+    }
+
+    // 差分阶段取出的槽位要等光斑检测完成才归还，期间最多有：
+    // 2 个队列各自装满，加上差分、拟合、光斑检测 3 个阶段各持有一对
+    const size_t queue_capacity = config_.queue_capacity;
+    const size_t max_held = 2 * queue_capacity + 3;
+    // 进入处理时已落后超过两个帧对周期（4 帧）即记为迟到
+    const double late_threshold_ms = source.fps() > 0 ? 4000.0 / source.fps() : 0.0;
+    FrameRing ring(config_.ring_capacity, cv::Size(source.width(), source.height()), CV_8UC1,
+                   max_held, late_threshold_ms, config_.realtime);
+    FramePairDemuxer demuxer;
+
+    BoundedQueue<PipelineItem> differenced(queue_capacity);
+    BoundedQueue<PipelineItem> fitted(queue_capacity);
+    BoundedQueue<PipelineItem> glinted(queue_capacity);
+
+    const int64_t start = cv::getTickCount();
+    std::thread decode_thread(&TrackingPipeline::decode_stage, this, std::ref(source), std::ref(demuxer), std::ref(ring));
+    std::thread difference_thread(&TrackingPipeline::difference_stage, this, std::ref(ring), std::ref(differenced));
+    std::thread fit_thread(&TrackingPipeline::fit_stage, this, std::ref(differenced), std::ref(fitted));
+    std::thread glint_thread(&TrackingPipeline::glint_stage, this, std::ref(ring), std::ref(fitted), std::ref(glinted));
+    std::thread gaze_thread(&TrackingPipeline::gaze_stage, this, std::ref(glinted), std::cref(on_result));
+
+    decode_thread.join();
+    difference_thread.join();
+    fit_thread.join();
+    glint_thread.join();
+    gaze_thread.join();
+
+    stats_.elapsed_sec = (cv::getTickCount() - start) / cv::getTickFrequency();
+    stats_.pairs = pairs_done_;
+    if (stats_.pairs > 0) {
+        for (int stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+            stats_.stage_mean_ms[stage] = stage_ticks_[stage] * 1000.0 / cv::getTickFrequency() / stats_.pairs;
+        }
+    }
+    stats_.dropped_pairs = ring.dropped();
+    stats_.late_pairs = ring.late();
+    return true;
+}
+
+void TrackingPipeline::decode_stage(VideoFrameSource& source, FramePairDemuxer& demuxer, FrameRing& ring) {
+    TRACE_THREAD_NAME("decode");
+    double timestamp = 0.0;
+    int frame_in_slot = 0; // 当前帧在槽位中的位置，一对中的两帧依次写入同一个槽位
+    int64_t start = cv::getTickCount();
+    while (true) {
+        FrameSlot& slot = ring.write_slot();
+        cv::Mat& frame = slot.frames[frame_in_slot];
+        bool decoded;
+        {
+            TRACE_SCOPE("decode_frame");
+            decoded = source.read_into(frame, &timestamp);
+        }
+        if (!decoded) {
+            break;
+        }
+        if (!demuxer.commit_external(frame, timestamp, slot.pair)) {
+            frame_in_slot = 1;
+            continue;
+        }
+        frame_in_slot = 0;
+        add_stage_time(STAGE_DECODE, cv::getTickCount() - start);
+        ring.publish();
+        start = cv::getTickCount();
+    }
+    ring.close();
+}
+
+void TrackingPipeline::difference_stage(FrameRing& ring, BoundedQueue<PipelineItem>& out) {
+    TRACE_THREAD_NAME("difference");
+    PipelineItem item;
+    while (FrameSlot* slot = ring.acquire()) {
+        const int64_t start = cv::getTickCount();
+        item.slot = slot;
+        item.pair = slot->pair;
+        item.result = TrackingResult();
+        item.result.index = item.pair.index;
+        item.result.timestamp = item.pair.light_timestamp;
+        item.mask = slot->mask;
+        compute_pupil_mask(item.pair.light, item.pair.dark, item.mask);
+        add_stage_time(STAGE_DIFFERENCE, cv::getTickCount() - start);
+        if (!out.push(std::move(item))) {
+            break;
+        }
+        item = PipelineItem();
+    }
+    out.close();
+}
+
+void TrackingPipeline::fit_stage(BoundedQueue<PipelineItem>& in, BoundedQueue<PipelineItem>& out) {
+    TRACE_THREAD_NAME("fit");
+    PipelineItem item;
+    while (in.pop(item)) {
+        const int64_t start = cv::getTickCount();
+        if (!item.mask.empty()) {
+            item.result.pupil = locate_pupil_in_mask(item.pair.light, item.pair.dark, item.mask);
+        }
+        add_stage_time(STAGE_FIT, cv::getTickCount() - start);
+        if (!out.push(std::move(item))) {
+            break;
+        }
+    }
+    out.close();
+}
+
+void TrackingPipeline::glint_stage(FrameRing& ring, BoundedQueue<PipelineItem>& in, BoundedQueue<PipelineItem>& out) {
+    TRACE_THREAD_NAME("glint");
+    PipelineItem item;
+    while (in.pop(item)) {
+        const int64_t start = cv::getTickCount();
+        // 明瞳图像中的普尔钦斑最清晰
+        item.result.reflection = reflection_detector_.process(item.pair.light);
+        add_stage_time(STAGE_GLINT, cv::getTickCount() - start);
+
+        // 后续阶段不再需要像素数据，归还槽位供采集线程复用
+        item.pair = FramePair();
+        item.mask.release();
+        ring.release(item.slot);
+        item.slot = nullptr;
+        if (!out.push(std::move(item))) {
+            break;
+        }
+    }
+    out.close();
+}
+
+void TrackingPipeline::gaze_stage(BoundedQueue<PipelineItem>& in, const ResultCallback& on_result) {
+    TRACE_THREAD_NAME("gaze");
+    PipelineItem item;
+    while (in.pop(item)) {
+        const int64_t start = cv::getTickCount();
+        TrackingResult& result = item.result;
+        if (result.pupil.found && result.reflection.found) {
+            result.pupil_glint_vector = result.pupil.center - result.reflection.center;
+            if (calibration_ != nullptr) {
+                result.gaze_point = calibration_->calculate_gaze_point(result.pupil_glint_vector);
+                result.gaze_valid = true;
+            }
+        }
+        add_stage_time(STAGE_GAZE, cv::getTickCount() - start);
+
+        if (on_result) {
+            on_result(result);
+        }
+        ++pairs_done_;
+    }
+}
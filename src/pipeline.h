@@ -0,0 +1,130 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "bounded_queue.h"
+#include "detection.h"
+#include "gaze_calibration.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class VideoFrameSource;
+class FramePairDemuxer;
+class FrameRing;
+struct PipelineItem;
+
+/**
+ * @brief 流水线的各个处理阶段，每个阶段运行在独立线程上。
+ */
+enum PipelineStage {
+    STAGE_DECODE = 0,   ///< 解码并拆分明暗帧对
+    STAGE_DIFFERENCE,   ///< 明暗瞳差分与二值化
+    STAGE_FIT,          ///< 轮廓提取与瞳孔椭圆拟合
+    STAGE_GLINT,        ///< 普尔钦斑检测
+    STAGE_GAZE,         ///< 视线映射
+    PIPELINE_STAGE_COUNT
+};
+
+/**
+ * @struct TrackingResult
+ * @brief 一个明暗帧对经过完整流水线后的结果。
+ */
+struct TrackingResult {
+    int64_t index = 0;                     ///< 帧对序号
+    double timestamp = 0.0;                ///< 明瞳帧时间戳（秒）
+    PupilResult pupil;                     ///< 瞳孔检测结果
+    ReflectionResult reflection;           ///< 光斑检测结果
+    bool gaze_valid = false;               ///< 是否得到了注视点
+    cv::Point2f pupil_glint_vector;        ///< 瞳孔中心减光斑中心的差向量
+    cv::Point2f gaze_point{-1.f, -1.f};    ///< 标定模型估计的屏幕注视点
+};
+
+/**
+ * @struct PipelineConfig
+ * @brief 流水线的配置参数。
+ */
+struct PipelineConfig {
+    size_t queue_capacity = 2;  ///< 相邻处理阶段之间队列的容量
+    size_t ring_capacity = 4;   ///< 采集与处理之间帧环的待处理容量（帧对）
+    bool realtime = false;      ///< 实时模式：处理跟不上时丢弃最旧的帧对；离线模式下采集等待处理
+    std::string eye_cascade_path = "haarcascades/haarcascade_eye.xml"; ///< 光斑检测使用的 Haar 级联分类器路径
+};
+
+/**
+ * @struct PipelineStats
+ * @brief 一次运行的吞吐量与各阶段平均耗时。
+ */
+struct PipelineStats {
+    int64_t pairs = 0;                                  ///< 处理的帧对数量
+    double elapsed_sec = 0.0;                           ///< 总耗时（秒）
+    double stage_mean_ms[PIPELINE_STAGE_COUNT] = {};    ///< 各阶段处理单个帧对的平均耗时（毫秒）
+    uint64_t dropped_pairs = 0;                         ///< 实时模式下因处理跟不上而丢弃的帧对数
+    uint64_t late_pairs = 0;                            ///< 进入处理时已超过两个帧对周期的帧对数
+
+    /**
+     * @brief 实测吞吐量（帧对/秒）。
+     */
+    double pairs_per_second() const { return elapsed_sec > 0 ? pairs / elapsed_sec : 0.0; }
+};
+
+/**
+ * @class TrackingPipeline
+ * @brief 多线程分阶段的眼动跟踪流水线。
+ *
+ * 解码、差分、拟合、光斑检测和视线映射分别运行在独立线程上。采集线程把帧
+ * 直接解码进预分配的无锁帧环 FrameRing，其余相邻阶段之间用有界队列连接：
+ * 第 N 对在拟合时，第 N+1 对已经在做差分。稳态吞吐量约为
+ * 1 / max(各阶段耗时)，帧环和队列容量限制了在途帧对的数量和内存占用。
+ */
+class TrackingPipeline {
+public:
+    using ResultCallback = std::function<void(const TrackingResult&)>;
+
+    /**
+     * @brief 构造流水线。
+     * @param calibration 已拟合的视线标定模型；为 nullptr 时只输出瞳孔-光斑向量。
+     * @param config 流水线配置。
+     */
+    explicit TrackingPipeline(const GazeCalibration* calibration = nullptr,
+                              const PipelineConfig& config = PipelineConfig());
+
+    /**
+     * @brief 处理整段明暗交替视频，直到视频结束。
+     *
+     * 结果按帧对顺序在视线映射线程上通过回调输出。
+     *
+     * @param video_path 视频文件路径或流地址。
+     * @param on_result 每个帧对处理完成后的回调。
+     * @return 视频打开成功并处理完毕返回 true。
+     */
+    bool run(const std::string& video_path, const ResultCallback& on_result);
+
+    /**
+     * @brief 最近一次 run() 的统计信息。
+     */
+    const PipelineStats& stats() const { return stats_; }
+
+private:
+    void decode_stage(VideoFrameSource& source, FramePairDemuxer& demuxer, FrameRing& ring);
+    void difference_stage(FrameRing& ring, BoundedQueue<PipelineItem>& out);
+    void fit_stage(BoundedQueue<PipelineItem>& in, BoundedQueue<PipelineItem>& out);
+    void glint_stage(FrameRing& ring, BoundedQueue<PipelineItem>& in, BoundedQueue<PipelineItem>& out);
+    void gaze_stage(BoundedQueue<PipelineItem>& in, const ResultCallback& on_result);
+
+    /**
+     * @brief 累加某阶段的处理耗时（cv::getTickCount 计数）。
+     */
+    void add_stage_time(PipelineStage stage, int64_t ticks);
+
+    const GazeCalibration* calibration_;
+    PipelineConfig config_;
+    ReflectionDetector reflection_detector_; // 只在光斑检测线程中使用
+
+    std::atomic<int64_t> stage_ticks_[PIPELINE_STAGE_COUNT];
+    std::atomic<int64_t> pairs_done_;
+    PipelineStats stats_;
+};
+
+#endif // PIPELINE_H
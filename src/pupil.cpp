@@ -1,10 +1,69 @@
 #include "detection.h"
+#include "trace.h"
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
 
-// 定义椭圆筛选的最小和最大面积
-const double MIN_ELLIPSE_AREA = 500.0;
-const double MAX_ELLIPSE_AREA = 3000.0;
+// 连通域预筛选：像素面积范围和二阶矩长短轴比下限，均比椭圆筛选宽松，
+// 只用于在拟合前排除明显不可能的噪点和条纹
+const int64_t MIN_BLOB_AREA = 250;
+const int64_t MAX_BLOB_AREA = 6000;
+const double MIN_BLOB_AXIS_RATIO = 0.6;
+
+// 通过预筛选后最多做轮廓跟踪和椭圆拟合的连通域个数。截断发生在置信度排序之前，
+// 需多于 MAX_PUPIL_CANDIDATES，给拟合后被长宽比门限淘汰的连通域留出余量
+const size_t MAX_FITTED_BLOBS = 2 * MAX_PUPIL_CANDIDATES;
+
+// 候选评分：内外对比度的采样圈（相对半轴的倍数）和每圈采样数
+const double CONTRAST_INNER_SCALE = 0.6;
+const double CONTRAST_OUTER_SCALE = 1.4;
+const int CONTRAST_SAMPLES = 32;
+
+// 候选评分：与上一帧中心距离的高斯衰减尺度（像素）
+const double PROXIMITY_SIGMA = 20.0;
+
+/**
+ * @brief 由二阶中心矩计算连通域等效椭圆的短轴/长轴之比。
+ */
+static double blob_axis_ratio(const BlobStats& blob) {
+    const double n = static_cast<double>(blob.area);
+    const double cx = blob.m10 / n;
+    const double cy = blob.m01 / n;
+    const double mu20 = blob.m20 / n - cx * cx;
+    const double mu02 = blob.m02 / n - cy * cy;
+    const double mu11 = blob.m11 / n - cx * cy;
+    const double root = std::sqrt((mu20 - mu02) * (mu20 - mu02) + 4 * mu11 * mu11);
+    const double lambda_major = (mu20 + mu02 + root) / 2;
+    const double lambda_minor = (mu20 + mu02 - root) / 2;
+    if (lambda_major <= 0) {
+        return 0.0;
+    }
+    return std::sqrt(std::max(0.0, lambda_minor) / lambda_major);
+}
+
+/**
+ * @brief 对图像进行预处理，包括灰度化、高斯模糊和二值化，结果写入调用方提供的缓冲区。
+ *
+ * 缓冲区尺寸和类型与输出一致时不会重新分配内存，可以是 FrameArena 的视图。
+ *
+ * @param image 输入图像。
+ * @param gray 灰度化结果缓冲区，灰度输入时不使用。
+ * @param blurred 高斯模糊结果缓冲区。
+ * @param binary 二值化结果缓冲区。
+ */
+void preprocess_image(const cv::Mat& image, cv::Mat& gray, cv::Mat& blurred, cv::Mat& binary) {
+    TRACE_SCOPE("preprocess_image");
+    const cv::Mat* source = &image; // 灰度输入（例如视频解码帧）无需转换，也无需拷贝
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+        source = &gray;
+    }
+    cv::GaussianBlur(*source, blurred, cv::Size(5, 5), 0);
+    cv::threshold(blurred, binary, PUPIL_MASK_THRESHOLD, 255, cv::THRESH_BINARY);
+}
 
 /**
  * @brief 对图像进行预处理，包括灰度化、高斯模糊和二值化。
@@ -14,85 +73,333 @@ const double MAX_ELLIPSE_AREA = 3000.0;
  */
 cv::Mat preprocess_image(const cv::Mat& image) {
     cv::Mat gray, blurred, binary;
-    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-    cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
-    cv::threshold(blurred, binary, 50, 255, cv::THRESH_BINARY);
+    preprocess_image(image, gray, blurred, binary);
     return binary;
 }
 
 /**
- * @brief 在图像中寻找符合条件的瞳孔轮廓。
+ * @brief 根据拟合椭圆与原始轮廓的吻合程度估计置信度。
  *
- * @param binary_image 预处理后的二值图像。
- * @return 瞳孔轮廓的向量。
+ * 置信度为椭圆短长轴之比与轮廓面积/椭圆面积填充率的乘积，两者都接近 1 时
+ * 说明轮廓是一个完整的近圆形瞳孔。
+ *
+ * @param contour 原始轮廓。
+ * @param ellipse_rect 对该轮廓拟合得到的椭圆。
+ * @return 范围 [0, 1] 的置信度。
  */
-std::vector<std::vector<cv::Point>> find_pupil_contours(const cv::Mat& binary_image) {
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(binary_image, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-    return contours;
+static float estimate_ellipse_confidence(const std::vector<cv::Point>& contour, const cv::RotatedRect& ellipse_rect) {
+    float major = std::max(ellipse_rect.size.width, ellipse_rect.size.height);
+    float minor = std::min(ellipse_rect.size.width, ellipse_rect.size.height);
+    double ellipse_area = ellipse_rect.size.width * ellipse_rect.size.height * CV_PI / 4.0;
+    double contour_area = cv::contourArea(contour);
+    if (major <= 0 || ellipse_area <= 0 || contour_area <= 0) {
+        return 0.f;
+    }
+    double fill = std::min(contour_area, ellipse_area) / std::max(contour_area, ellipse_area);
+    return static_cast<float>((minor / major) * fill);
 }
 
 /**
- * @brief 从轮廓中筛选出最可能是瞳孔的椭圆。
+ * @brief 明暗瞳两帧在 (x, y) 处的灰度差分值，与 absdiff + cvtColor(BGR2GRAY) 一致（不取整）。
+ */
+template <typename T>
+static double gray_difference(const cv::Mat& light_image, const cv::Mat& dark_image, int x, int y) {
+    const int channels = light_image.channels();
+    const T* light = light_image.ptr<T>(y) + x * channels;
+    const T* dark = dark_image.ptr<T>(y) + x * channels;
+    const double b = std::abs(static_cast<double>(light[0]) - dark[0]);
+    if (channels < 3) {
+        return b;
+    }
+    const double g = std::abs(static_cast<double>(light[1]) - dark[1]);
+    const double r = std::abs(static_cast<double>(light[2]) - dark[2]);
+    return 0.114 * b + 0.587 * g + 0.299 * r;
+}
+
+/**
+ * @brief 在椭圆内侧和外侧各取一圈采样点，返回两者平均灰度差分值之差（/ PUPIL_MASK_THRESHOLD，截断到 [0, 1]）。
+ *
+ * 直接在明暗瞳两帧上采样差分值，不需要整帧的灰度差分图像；二值图像上的内外差
+ * 只反映填充程度，与圆度重复。没有可用的明暗瞳图像时返回 1，即不参与评分。
  *
- * @param contours 轮廓向量。
- * @param image_for_drawing 用于绘制的原始图像。
- * @return 检测到的瞳孔中心点。如果未找到，则返回 (-1, -1)。
+ * @param light_image 明瞳图像，与二值图像同尺寸（可以为空）。
+ * @param dark_image 暗瞳图像，尺寸和类型与明瞳图像相同。
+ * @param ellipse_rect 候选椭圆。
  */
-cv::Point2f find_best_pupil_ellipse(const std::vector<std::vector<cv::Point>>& contours, cv::Mat& image_for_drawing) {
-    cv::Point2f pupil_center(-1, -1);
-
-    for (const auto& contour : contours) {
-        if (contour.size() > 5) { // 椭圆拟合至少需要6个点
-            cv::RotatedRect ellipse_rect = cv::fitEllipse(contour);
-            double area = ellipse_rect.size.width * ellipse_rect.size.height * CV_PI / 4.0;
-
-            // 根据面积和形状筛选
-            if (area > MIN_ELLIPSE_AREA && area < MAX_ELLIPSE_AREA) {
-                float aspect_ratio = ellipse_rect.size.width / ellipse_rect.size.height;
-                if (aspect_ratio > 0.75 && aspect_ratio < 1.25) { // 接近圆形
-                    pupil_center = ellipse_rect.center;
-                    cv::ellipse(image_for_drawing, ellipse_rect, cv::Scalar(0, 255, 0), 2);
-                    break; // 找到一个就停止
-                }
+static float estimate_ellipse_contrast(const cv::Mat& light_image, const cv::Mat& dark_image,
+                                       const cv::RotatedRect& ellipse_rect) {
+    if (light_image.empty() || light_image.size() != dark_image.size() || light_image.type() != dark_image.type()) {
+        return 1.f;
+    }
+    double (*sample)(const cv::Mat&, const cv::Mat&, int, int) = nullptr;
+    switch (light_image.depth()) {
+    case CV_8U: sample = gray_difference<uchar>; break;
+    case CV_16U: sample = gray_difference<ushort>; break;
+    case CV_32F: sample = gray_difference<float>; break;
+    default: return 1.f;
+    }
+
+    const double angle = ellipse_rect.angle * CV_PI / 180.0;
+    const double cos_a = std::cos(angle), sin_a = std::sin(angle);
+    double sums[2] = {0.0, 0.0};
+    int counts[2] = {0, 0};
+    for (int ring = 0; ring < 2; ++ring) {
+        const double k = ring == 0 ? CONTRAST_INNER_SCALE : CONTRAST_OUTER_SCALE;
+        const double a = ellipse_rect.size.width / 2.0 * k;
+        const double b = ellipse_rect.size.height / 2.0 * k;
+        for (int i = 0; i < CONTRAST_SAMPLES; ++i) {
+            const double t = 2.0 * CV_PI * i / CONTRAST_SAMPLES;
+            const double u = a * std::cos(t), v = b * std::sin(t);
+            const int x = cvRound(ellipse_rect.center.x + u * cos_a - v * sin_a);
+            const int y = cvRound(ellipse_rect.center.y + u * sin_a + v * cos_a);
+            if (x >= 0 && y >= 0 && x < light_image.cols && y < light_image.rows) {
+                sums[ring] += sample(light_image, dark_image, x, y);
+                ++counts[ring];
             }
         }
     }
-    return pupil_center;
+    if (counts[0] == 0) {
+        return 0.f;
+    }
+    // 按二值化阈值归一化：瞳孔内侧的差分值刚好超过阈值、外侧接近 0 时即为满分。
+    // 实拍图像的瞳孔内侧差分值通常只有 55–70，按 8 位灰度范围归一化会让置信度整体偏低
+    const double inside = sums[0] / counts[0];
+    const double outside = counts[1] > 0 ? sums[1] / counts[1] : 0.0;
+    return static_cast<float>(std::max(0.0, std::min(1.0, (inside - outside) / PUPIL_MASK_THRESHOLD)));
 }
 
-void detect_pupil(const std::string& light_image_path, const std::string& dark_image_path, const std::string& output_file) {
-    cv::Mat light_image = cv::imread(light_image_path);
-    cv::Mat dark_image = cv::imread(dark_image_path);
+/**
+ * @brief 对一个连通域的外轮廓拟合椭圆，通过面积和形状筛选的椭圆评分后插入候选数组。
+ *
+ * @param contour 外轮廓。
+ * @param fitter 椭圆拟合器（直接最小二乘，必要时 RANSAC）。
+ * @param light_image 用于计算内外对比度的明瞳图像（可以为空）。
+ * @param dark_image 暗瞳图像。
+ * @param previous_center 上一帧的瞳孔中心，(-1, -1) 表示没有。
+ * @param ranked 候选数组，新候选按置信度插入。
+ */
+static void find_best_pupil_ellipse(const std::vector<cv::Point>& contour, EllipseFitter& fitter,
+                                    const cv::Mat& light_image, const cv::Mat& dark_image,
+                                    const cv::Point2f& previous_center, PupilCandidates& ranked) {
+    TRACE_SCOPE("find_best_pupil_ellipse");
+    EllipseFit fit;
+    if (contour.size() <= 5 || !fitter.fit(contour, fit)) { // 椭圆拟合至少需要6个点
+        return;
+    }
+    const cv::RotatedRect& ellipse_rect = fit.ellipse;
+    double area = ellipse_rect.size.width * ellipse_rect.size.height * CV_PI / 4.0;
 
-    if (light_image.empty() || dark_image.empty()) {
-        std::cerr << "Error: Could not load images for pupil detection." << std::endl;
+    // 根据面积和形状筛选
+    if (area <= MIN_ELLIPSE_AREA || area >= MAX_ELLIPSE_AREA) {
         return;
     }
+    float aspect_ratio = ellipse_rect.size.width / ellipse_rect.size.height;
+    if (aspect_ratio <= 0.75 || aspect_ratio >= 1.25) { // 接近圆形
+        return;
+    }
+
+    PupilCandidate candidate;
+    candidate.ellipse = ellipse_rect;
+    candidate.fit = fit.inlier_ratio() / (1.f + fit.rms_residual);
+    candidate.circularity = estimate_ellipse_confidence(contour, ellipse_rect);
+    candidate.contrast = estimate_ellipse_contrast(light_image, dark_image, ellipse_rect);
+    if (previous_center.x >= 0 && previous_center.y >= 0) {
+        const cv::Point2f delta = ellipse_rect.center - previous_center;
+        const double distance2 = delta.x * delta.x + delta.y * delta.y;
+        candidate.proximity = static_cast<float>(std::exp(-distance2 / (2.0 * PROXIMITY_SIGMA * PROXIMITY_SIGMA)));
+    }
+    candidate.confidence = candidate.fit * candidate.circularity * candidate.contrast * candidate.proximity;
+    ranked.insert(candidate);
+}
+
+/**
+ * @brief 检查明暗瞳图像对是否可以差分。
+ */
+static bool check_pupil_pair(const cv::Mat& light_image, const cv::Mat& dark_image) {
+    if (light_image.empty() || dark_image.empty()) {
+        return false;
+    }
+    if (light_image.size() != dark_image.size() || light_image.type() != dark_image.type()) {
+        std::cerr << "Error: Light and dark images must have the same size and type." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 输入是否可以走单遍融合实现（结果与逐步处理一致）。
+ */
+static bool use_fused_mask(const cv::Mat& image) {
+    return (image.type() == CV_8UC1 || image.type() == CV_8UC3) && image.rows >= 3 && image.cols >= 3;
+}
+
+bool compute_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat& binary_mask) {
+    TRACE_SCOPE("compute_pupil_mask");
+    if (!check_pupil_pair(light_image, dark_image)) {
+        return false;
+    }
+    if (use_fused_mask(light_image)) {
+        fused_pupil_mask(light_image, dark_image, binary_mask);
+        return true;
+    }
 
     // 1. 图像差分
     cv::Mat diff_image;
     cv::absdiff(light_image, dark_image, diff_image);
 
     // 2. 预处理
-    cv::Mat binary_diff = preprocess_image(diff_image);
+    binary_mask = preprocess_image(diff_image);
+    return true;
+}
+
+bool compute_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, PupilWorkspace& workspace,
+                        cv::Mat& binary_mask) {
+    TRACE_SCOPE("compute_pupil_mask");
+    if (!check_pupil_pair(light_image, dark_image)) {
+        return false;
+    }
+    FrameArena& arena = workspace.arena;
+    const cv::Size size = light_image.size();
+    if (use_fused_mask(light_image)) {
+        binary_mask = arena.mat(size, CV_8UC1);
+        fused_pupil_mask(light_image, dark_image, binary_mask, workspace);
+        return true;
+    }
+
+    // 其他类型逐步处理，中间结果同样取自 arena
+    const int gray_type = CV_MAKETYPE(light_image.depth(), 1);
+    cv::Mat diff_image = arena.mat(size, light_image.type());
+    cv::Mat gray = light_image.channels() == 3 ? arena.mat(size, gray_type) : cv::Mat();
+    cv::Mat blurred = arena.mat(size, gray_type);
+    binary_mask = arena.mat(size, gray_type);
+    cv::absdiff(light_image, dark_image, diff_image);
+    preprocess_image(diff_image, gray, blurred, binary_mask);
+    return true;
+}
+
+PupilResult locate_pupil_in_mask(const cv::Mat& binary_mask) {
+    // 每个线程一个拟合器，各自持有缓冲区和帧时间预算
+    return locate_pupil_in_mask(binary_mask, thread_pupil_workspace().fitter);
+}
+
+/**
+ * @brief 取置信度最高的候选作为检测结果。
+ */
+static PupilResult best_pupil(const PupilCandidates& ranked) {
+    PupilResult result;
+    if (!ranked.empty()) {
+        result.found = true;
+        result.center = ranked.best().ellipse.center;
+        result.ellipse = ranked.best().ellipse;
+        result.confidence = ranked.best().confidence;
+    }
+    return result;
+}
+
+PupilResult locate_pupil_in_mask(const cv::Mat& binary_mask, EllipseFitter& fitter) {
+    return locate_pupil_in_mask(cv::Mat(), cv::Mat(), binary_mask, fitter);
+}
+
+PupilResult locate_pupil_in_mask(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask) {
+    return locate_pupil_in_mask(light_image, dark_image, binary_mask, thread_pupil_workspace().fitter);
+}
+
+PupilResult locate_pupil_in_mask(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                                 EllipseFitter& fitter) {
+    PupilCandidates ranked;
+    rank_pupil_candidates(light_image, dark_image, binary_mask, fitter, cv::Point2f(-1.f, -1.f), ranked);
+    return best_pupil(ranked);
+}
+
+/**
+ * @brief rank_pupil_candidates 的实现，连通域、轮廓等缓冲区取自 workspace，拟合器可以另外指定。
+ */
+static void rank_candidates(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                            EllipseFitter& fitter, PupilWorkspace& workspace, const cv::Point2f& previous_center,
+                            PupilCandidates& ranked) {
+    TRACE_SCOPE("rank_pupil_candidates");
+    ranked = PupilCandidates();
+    fitter.begin_frame();
+
+    // 3. 连通域标记，按面积和二阶矩长短轴比预筛选
+    const std::vector<BlobStats>& blobs = workspace.labeler.label(binary_mask);
 
-    // 3. 寻找轮廓
-    std::vector<std::vector<cv::Point>> contours = find_pupil_contours(binary_diff);
+    std::vector<std::pair<double, size_t>>& candidates = workspace.candidates; // (长短轴比, 下标)
+    candidates.clear();
+    for (size_t i = 0; i < blobs.size(); ++i) {
+        if (blobs[i].area < MIN_BLOB_AREA || blobs[i].area > MAX_BLOB_AREA) {
+            continue;
+        }
+        const double ratio = blob_axis_ratio(blobs[i]);
+        if (ratio >= MIN_BLOB_AXIS_RATIO) {
+            candidates.emplace_back(ratio, i);
+        }
+    }
+    // 越接近圆形越先尝试，最多评估 MAX_FITTED_BLOBS 个
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) { return a.first > b.first; });
+    if (candidates.size() > MAX_FITTED_BLOBS) {
+        candidates.resize(MAX_FITTED_BLOBS);
+    }
+
+    // 4. 只对留下的连通域跟踪外轮廓并拟合椭圆；从连通域自身的起点跟踪，
+    //    不会混入外接矩形内其他连通域的轮廓
+    for (const auto& candidate : candidates) {
+        {
+            TRACE_SCOPE("find_pupil_contours");
+            trace_outer_contour(binary_mask, blobs[candidate.second].start, cv::Point(), workspace.contour);
+        }
+        find_best_pupil_ellipse(workspace.contour, fitter, light_image, dark_image, previous_center, ranked);
+    }
+}
+
+void rank_pupil_candidates(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                           EllipseFitter& fitter, const cv::Point2f& previous_center, PupilCandidates& ranked) {
+    rank_candidates(light_image, dark_image, binary_mask, fitter, thread_pupil_workspace(), previous_center, ranked);
+}
+
+void rank_pupil_candidates(const cv::Mat& light_image, const cv::Mat& dark_image, const cv::Mat& binary_mask,
+                           PupilWorkspace& workspace, const cv::Point2f& previous_center, PupilCandidates& ranked) {
+    rank_candidates(light_image, dark_image, binary_mask, workspace.fitter, workspace, previous_center, ranked);
+}
+
+PupilResult detect_pupil(const cv::Mat& light_image, const cv::Mat& dark_image) {
+    return detect_pupil(light_image, dark_image, thread_pupil_workspace());
+}
+
+PupilResult detect_pupil(const cv::Mat& light_image, const cv::Mat& dark_image, PupilWorkspace& workspace) {
+    TRACE_SCOPE("detect_pupil");
+    workspace.begin_frame();
+    cv::Mat binary_diff;
+    if (!compute_pupil_mask(light_image, dark_image, workspace, binary_diff)) {
+        return PupilResult();
+    }
+    PupilCandidates ranked;
+    rank_pupil_candidates(light_image, dark_image, binary_diff, workspace, cv::Point2f(-1.f, -1.f), ranked);
+    return best_pupil(ranked);
+}
+
+void detect_pupil(const std::string& light_image_path, const std::string& dark_image_path, const std::string& output_file) {
+    cv::Mat light_image = cv::imread(light_image_path);
+    cv::Mat dark_image = cv::imread(dark_image_path);
+
+    if (light_image.empty() || dark_image.empty()) {
+        std::cerr << "Error: Could not load images for pupil detection." << std::endl;
+        return;
+    }
 
-    // 4. 寻找最佳瞳孔椭圆
-    cv::Mat image_for_drawing = light_image.clone();
-    cv::Point2f pupil_center = find_best_pupil_ellipse(contours, image_for_drawing);
+    PupilResult pupil = detect_pupil(light_image, dark_image);
 
-    // 5. 保存结果
-    if (pupil_center.x != -1) {
+    // 保存结果
+    if (pupil.found) {
         std::ofstream outfile(output_file);
         if (outfile.is_open()) {
-            outfile << pupil_center.x << " " << pupil_center.y << std::endl;
+            outfile << pupil.center.x << " " << pupil.center.y << std::endl;
             outfile.close();
         }
-        // 可选：显示结果图像
-        // cv::imshow("Pupil Detection", image_for_drawing);
+        // 可选：显示结果图像（light_image 是本函数读入的副本，直接在上面绘制，无需再拷贝）
+        // cv::ellipse(light_image, pupil.ellipse, cv::Scalar(0, 255, 0), 2);
+        // cv::imshow("Pupil Detection", light_image);
         // cv::waitKey(0);
     }
 }
@@ -0,0 +1,212 @@
+#include "detection.h"
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// BGR2GRAY 定点系数（14 位小数），与 OpenCV cvtColor 的 8 位实现一致
+static const int GRAY_B = 1868;
+static const int GRAY_G = 9617;
+static const int GRAY_R = 4899;
+static const int GRAY_SHIFT = 14;
+
+// 每个并行条带的最少输出行数，条带开头需要额外读取 4 行
+static const int MIN_STRIPE_ROWS = 32;
+
+/**
+ * @brief BORDER_REFLECT_101 边界下的下标映射，要求 n >= 3 且 i ∈ [-2, n + 1]。
+ */
+static inline int reflect101(int i, int n) {
+    return i < 0 ? -i : (i >= n ? 2 * n - 2 - i : i);
+}
+
+/**
+ * @brief 一行的明暗瞳差分与灰度化：gray = BGR2GRAY(|light - dark|)。
+ */
+static void diff_gray_row(const uchar* light, const uchar* dark, uchar* gray, int width, int channels) {
+    int x = 0;
+    if (channels == 1) {
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+        for (; x <= width - lanes; x += lanes) {
+            cv::v_store(gray + x, cv::v_absdiff(cv::vx_load(light + x), cv::vx_load(dark + x)));
+        }
+#endif
+        for (; x < width; ++x) {
+            gray[x] = static_cast<uchar>(std::abs(light[x] - dark[x]));
+        }
+        return;
+    }
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const cv::v_uint16 coeff_b = cv::vx_setall_u16(GRAY_B);
+    const cv::v_uint16 coeff_g = cv::vx_setall_u16(GRAY_G);
+    const cv::v_uint16 coeff_r = cv::vx_setall_u16(GRAY_R);
+    const cv::v_uint32 round = cv::vx_setall_u32(1u << (GRAY_SHIFT - 1));
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_uint8 lb, lg, lr, db, dg, dr;
+        cv::v_load_deinterleave(light + 3 * x, lb, lg, lr);
+        cv::v_load_deinterleave(dark + 3 * x, db, dg, dr);
+        cv::v_uint16 b[2], g[2], r[2];
+        cv::v_expand(cv::v_absdiff(lb, db), b[0], b[1]);
+        cv::v_expand(cv::v_absdiff(lg, dg), g[0], g[1]);
+        cv::v_expand(cv::v_absdiff(lr, dr), r[0], r[1]);
+
+        cv::v_uint16 result[2];
+        for (int half = 0; half < 2; ++half) {
+            // 系数与 8 位通道值的乘积最大 255 * 9617，需要 32 位累加
+            cv::v_uint32 sum_lo, sum_hi, lo, hi;
+            cv::v_mul_expand(b[half], coeff_b, sum_lo, sum_hi);
+            cv::v_mul_expand(g[half], coeff_g, lo, hi);
+            sum_lo = cv::v_add(sum_lo, lo);
+            sum_hi = cv::v_add(sum_hi, hi);
+            cv::v_mul_expand(r[half], coeff_r, lo, hi);
+            sum_lo = cv::v_add(cv::v_add(sum_lo, lo), round);
+            sum_hi = cv::v_add(cv::v_add(sum_hi, hi), round);
+            result[half] = cv::v_pack(cv::v_shr<GRAY_SHIFT>(sum_lo), cv::v_shr<GRAY_SHIFT>(sum_hi));
+        }
+        cv::v_store(gray + x, cv::v_pack(result[0], result[1]));
+    }
+#endif
+    for (; x < width; ++x) {
+        const int b = std::abs(light[3 * x] - dark[3 * x]);
+        const int g = std::abs(light[3 * x + 1] - dark[3 * x + 1]);
+        const int r = std::abs(light[3 * x + 2] - dark[3 * x + 2]);
+        gray[x] = static_cast<uchar>((b * GRAY_B + g * GRAY_G + r * GRAY_R + (1 << (GRAY_SHIFT - 1))) >> GRAY_SHIFT);
+    }
+}
+
+/**
+ * @brief 纵向 [1 4 6 4 1] 加权：sums = r0 + 4 r1 + 6 r2 + 4 r3 + r4（最大 4080，16 位）。
+ */
+static void vertical_row(const uchar* r0, const uchar* r1, const uchar* r2, const uchar* r3, const uchar* r4,
+                         ushort* sums, int width) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint16>::vlanes();
+    for (; x <= width - lanes; x += lanes) {
+        const cv::v_uint16 outer = cv::v_add(cv::vx_load_expand(r0 + x), cv::vx_load_expand(r4 + x));
+        const cv::v_uint16 inner = cv::v_add(cv::vx_load_expand(r1 + x), cv::vx_load_expand(r3 + x));
+        const cv::v_uint16 center = cv::vx_load_expand(r2 + x);
+        const cv::v_uint16 center6 = cv::v_add(cv::v_shl<2>(center), cv::v_shl<1>(center));
+        cv::v_store(sums + x, cv::v_add(cv::v_add(outer, cv::v_shl<2>(inner)), center6));
+    }
+#endif
+    for (; x < width; ++x) {
+        sums[x] = static_cast<ushort>(r0[x] + r4[x] + 4 * (r1[x] + r3[x]) + 6 * r2[x]);
+    }
+}
+
+/**
+ * @brief 横向 [1 4 6 4 1] 加权、(sum + 128) >> 8 舍入并二值化。
+ *
+ * @param sums 纵向加权和，sums[-2]、sums[-1]、sums[width]、sums[width + 1] 须已按 REFLECT_101 填好。
+ * @param dst 输出的二值行（0 或 255）。
+ */
+static void horizontal_threshold_row(const ushort* sums, uchar* dst, int width) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    // 总和最大 65280，加上舍入量 128 后仍在 16 位范围内
+    const int lanes = cv::VTraits<cv::v_uint16>::vlanes();
+    const cv::v_uint16 round = cv::vx_setall_u16(128);
+    const cv::v_uint16 threshold = cv::vx_setall_u16(PUPIL_MASK_THRESHOLD);
+    for (; x <= width - 2 * lanes; x += 2 * lanes) {
+        cv::v_uint16 mask[2];
+        for (int half = 0; half < 2; ++half) {
+            const ushort* s = sums + x + half * lanes;
+            const cv::v_uint16 outer = cv::v_add(cv::vx_load(s - 2), cv::vx_load(s + 2));
+            const cv::v_uint16 inner = cv::v_add(cv::vx_load(s - 1), cv::vx_load(s + 1));
+            const cv::v_uint16 center = cv::vx_load(s);
+            const cv::v_uint16 center6 = cv::v_add(cv::v_shl<2>(center), cv::v_shl<1>(center));
+            const cv::v_uint16 sum = cv::v_add(cv::v_add(outer, cv::v_shl<2>(inner)), center6);
+            const cv::v_uint16 blurred = cv::v_shr<8>(cv::v_add(sum, round));
+            mask[half] = cv::v_gt(blurred, threshold); // 全 1 掩码，打包时饱和为 255
+        }
+        cv::v_store(dst + x, cv::v_pack(mask[0], mask[1]));
+    }
+#endif
+    for (; x < width; ++x) {
+        const int sum = sums[x - 2] + sums[x + 2] + 4 * (sums[x - 1] + sums[x + 1]) + 6 * sums[x];
+        dst[x] = ((sum + 128) >> 8) > PUPIL_MASK_THRESHOLD ? 255 : 0;
+    }
+}
+
+/**
+ * @brief 条带数：每个条带至少 MIN_STRIPE_ROWS 行。
+ */
+static int stripe_count(int rows) {
+    return std::max(1, rows / MIN_STRIPE_ROWS);
+}
+
+/**
+ * @brief 每个条带的缓冲字节数：一行带 2 列边界的纵向加权和（16 位）加 5 行灰度滚动缓冲，按 64 字节对齐。
+ */
+static size_t stripe_stride(int cols) {
+    const size_t bytes = (static_cast<size_t>(cols) + 4) * sizeof(ushort) + 5 * static_cast<size_t>(cols);
+    return (bytes + 63) & ~static_cast<size_t>(63);
+}
+
+size_t fused_pupil_mask_buffer_size(const cv::Size& size) {
+    return stripe_count(size.height) * stripe_stride(size.width);
+}
+
+void fused_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat& binary_mask) {
+    fused_pupil_mask(light_image, dark_image, binary_mask, thread_pupil_workspace());
+}
+
+void fused_pupil_mask(const cv::Mat& light_image, const cv::Mat& dark_image, cv::Mat& binary_mask,
+                      PupilWorkspace& workspace) {
+    const int rows = light_image.rows;
+    const int cols = light_image.cols;
+    const int channels = light_image.channels();
+    CV_Assert(light_image.size() == dark_image.size() && light_image.type() == dark_image.type());
+    CV_Assert((light_image.type() == CV_8UC1 || light_image.type() == CV_8UC3) && rows >= 3 && cols >= 3);
+    if (binary_mask.data == light_image.data || binary_mask.data == dark_image.data) {
+        binary_mask.release(); // 输出不能与输入共用内存，条带会提前读取后面的行
+    }
+    binary_mask.create(light_image.size(), CV_8UC1);
+
+    // 各条带的缓冲在并行之前一次性准备好，容量只增不减
+    const int stripes = stripe_count(rows);
+    const size_t stride = stripe_stride(cols);
+    std::vector<uchar>& buffer = workspace.stripe_buffer;
+    if (buffer.size() < stripes * stride) {
+        buffer.resize(stripes * stride);
+    }
+
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int stripe = range.start; stripe < range.end; ++stripe) {
+            const int y_begin = static_cast<int>(static_cast<int64_t>(stripe) * rows / stripes);
+            const int y_end = static_cast<int>(static_cast<int64_t>(stripe + 1) * rows / stripes);
+
+            // 一行带 2 列边界的纵向加权和，以及 5 行灰度滚动缓冲（按行号 % 5 存放）
+            uchar* base = buffer.data() + stripe * stride;
+            ushort* sums = reinterpret_cast<ushort*>(base) + 2;
+            uchar* ring = base + (cols + 4) * sizeof(ushort);
+
+            int next_source_row = std::max(0, y_begin - 2);
+            for (int y = y_begin; y < y_end; ++y) {
+                // 补齐到第 y + 2 行（下边界反射后所需的行都已在缓冲中）
+                for (; next_source_row <= std::min(rows - 1, y + 2); ++next_source_row) {
+                    diff_gray_row(light_image.ptr<uchar>(next_source_row), dark_image.ptr<uchar>(next_source_row),
+                                  ring + (next_source_row % 5) * cols, cols, channels);
+                }
+
+                const uchar* lines[5];
+                for (int k = 0; k < 5; ++k) {
+                    lines[k] = ring + (reflect101(y - 2 + k, rows) % 5) * cols;
+                }
+                vertical_row(lines[0], lines[1], lines[2], lines[3], lines[4], sums, cols);
+                sums[-2] = sums[2];
+                sums[-1] = sums[1];
+                sums[cols] = sums[cols - 2];
+                sums[cols + 1] = sums[cols - 3];
+
+                horizontal_threshold_row(sums, binary_mask.ptr<uchar>(y), cols);
+            }
+        }
+    });
+}
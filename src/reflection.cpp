@@ -1,7 +1,27 @@
 #include "detection.h"
+#include "trace.h"
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <algorithm>
+#include <utility>
+
+/**
+ * @brief 对灰度眼睛区域进行预处理，结果写入调用方提供的缓冲区。
+ *
+ * 缓冲区尺寸不变时不会重新分配内存，适合逐帧复用。
+ *
+ * @param gray_eye_region 灰度眼睛区域图像。
+ * @param blurred 高斯模糊结果缓冲区。
+ * @param binary 二值化结果缓冲区。
+ */
+void preprocess_for_reflection(const cv::Mat& gray_eye_region, cv::Mat& blurred, cv::Mat& binary) {
+    TRACE_SCOPE("preprocess_for_reflection");
+    // 使用高斯模糊平滑图像，为阈值化做准备
+    cv::GaussianBlur(gray_eye_region, blurred, cv::Size(3, 3), 0);
+
+    // 使用一个较高的阈值来分离出明亮的反射光斑
+    cv::threshold(blurred, binary, 230, 255, cv::THRESH_BINARY);
+}
 
 /**
  * @brief 对眼睛区域进行预处理，以凸显反射光斑。
@@ -14,15 +34,9 @@ cv::Mat preprocess_for_reflection(const cv::Mat& eye_region) {
     if (eye_region.channels() == 3) {
         cv::cvtColor(eye_region, gray, cv::COLOR_BGR2GRAY);
     } else {
-        gray = eye_region.clone();
+        gray = eye_region;
     }
-
-    // 使用高斯模糊平滑图像，为阈值化做准备
-    cv::GaussianBlur(gray, blurred, cv::Size(3, 3), 0);
-
-    // 使用一个较高的阈值来分离出明亮的反射光斑
-    cv::threshold(blurred, binary, 230, 255, cv::THRESH_BINARY);
-
+    preprocess_for_reflection(gray, blurred, binary);
     return binary;
 }
 
@@ -59,6 +73,114 @@ cv::Point2f find_largest_contour_center(const std::vector<std::vector<cv::Point>
     return cv::Point2f(-1, -1);
 }
 
+ReflectionDetector::ReflectionDetector(const std::string& eye_cascade_path) {
+    loaded_ = eye_cascade_.load(eye_cascade_path);
+    if (!loaded_) {
+        std::cerr << "Error: Could not load eye cascade classifier." << std::endl;
+    }
+}
+
+const cv::Mat& ReflectionDetector::to_gray(const cv::Mat& image) {
+    if (image.channels() == 1) {
+        return image;
+    }
+    cv::cvtColor(image, gray_, cv::COLOR_BGR2GRAY);
+    return gray_;
+}
+
+ReflectionResult ReflectionDetector::process(const cv::Mat& image) {
+    TRACE_SCOPE("detect_reflection");
+    ReflectionResult result;
+    if (!loaded_ || image.empty()) {
+        return result;
+    }
+
+    // 级联分类器内部同样会先转为灰度图，这里只转换一次并与光斑检测共用
+    const cv::Mat& gray = to_gray(image);
+
+    // 使用Haar级联分类器检测眼睛
+    detect_eyes_gray(gray);
+    if (eyes_.empty()) {
+        return result;
+    }
+
+    // 假设我们只关心第一个检测到的眼睛
+    const cv::Rect eye_roi = eyes_[0] & cv::Rect(0, 0, gray.cols, gray.rows);
+    arena_.reset();
+    return find_in_roi(gray(eye_roi), eye_roi);
+}
+
+const std::vector<cv::Rect>& ReflectionDetector::detect_eyes(const cv::Mat& image) {
+    eyes_.clear();
+    if (loaded_ && !image.empty()) {
+        detect_eyes_gray(to_gray(image));
+    }
+    return eyes_;
+}
+
+void ReflectionDetector::detect_eyes_gray(const cv::Mat& gray) {
+    TRACE_SCOPE("eye_cascade");
+    eye_cascade_.detectMultiScale(gray, eyes_, 1.1, 4, 0, cv::Size(30, 30));
+}
+
+ReflectionResult ReflectionDetector::process(const cv::Mat& image, const cv::Rect& eye_roi) {
+    const cv::Rect roi = eye_roi & cv::Rect(0, 0, image.cols, image.rows);
+    if (roi.empty()) {
+        return ReflectionResult();
+    }
+
+    // 先裁剪再灰度化，逐帧的颜色转换只覆盖眼睛区域
+    arena_.reset();
+    cv::Mat gray = image(roi);
+    if (image.channels() != 1) {
+        gray = arena_.mat(roi.size(), CV_MAKETYPE(image.depth(), 1));
+        cv::cvtColor(image(roi), gray, cv::COLOR_BGR2GRAY);
+    }
+    return find_in_roi(gray, roi);
+}
+
+ReflectionResult ReflectionDetector::find_in_roi(const cv::Mat& gray, const cv::Rect& eye_roi) {
+    TRACE_SCOPE("find_reflection_in_roi");
+    ReflectionResult result;
+    result.eye_roi = eye_roi;
+    if (gray.empty()) {
+        return result;
+    }
+    result.eye_found = true;
+
+    // 预处理眼睛区域以寻找光斑
+    cv::Mat blurred = arena_.mat(gray.size(), gray.type());
+    cv::Mat binary = arena_.mat(gray.size(), gray.type());
+    preprocess_for_reflection(gray, blurred, binary);
+
+    // 找到最大轮廓的中心
+    result.center = largest_contour_center(binary, eye_roi.tl());
+    result.found = result.center.x != -1;
+    return result;
+}
+
+cv::Point2f ReflectionDetector::largest_contour_center(const cv::Mat& binary, const cv::Point& offset) {
+    // 与 findContours(RETR_EXTERNAL) 后取最大轮廓等价：位于其他连通域孔洞内的连通域
+    // 面积必然小于外层轮廓，不会被选中
+    double max_area = 0;
+    largest_contour_.clear();
+    for (const BlobStats& blob : labeler_.label(binary)) {
+        trace_outer_contour(binary, blob.start, cv::Point(), contour_);
+        const double area = cv::contourArea(contour_);
+        if (area > max_area) {
+            max_area = area;
+            std::swap(largest_contour_, contour_);
+        }
+    }
+    if (largest_contour_.empty()) {
+        return cv::Point2f(-1, -1);
+    }
+
+    // 计算最大轮廓的矩，中心点加上眼睛区域的偏移
+    cv::Moments mu = cv::moments(largest_contour_);
+    return cv::Point2f(mu.m10 / mu.m00 + offset.x, mu.m01 / mu.m00 + offset.y);
+}
+
 void detect_reflection(const std::string& image_path, const std::string& output_file) {
     cv::Mat image = cv::imread(image_path);
     if (image.empty()) {
@@ -66,45 +188,28 @@ void detect_reflection(const std::string& image_path, const std::string& output_
         return;
     }
 
-    // 使用Haar级联分类器检测眼睛
-    cv::CascadeClassifier eye_cascade;
-    if (!eye_cascade.load("haarcascades/haarcascade_eye.xml")) {
-        std::cerr << "Error: Could not load eye cascade classifier." << std::endl;
+    // 单次调用的便捷接口；逐帧处理请直接复用 ReflectionDetector 实例
+    ReflectionDetector detector;
+    if (!detector.is_loaded()) {
         return;
     }
 
-    std::vector<cv::Rect> eyes;
-    eye_cascade.detectMultiScale(image, eyes, 1.1, 4, 0, cv::Size(30, 30));
-
-    if (eyes.empty()) {
+    ReflectionResult reflection = detector.process(image);
+    if (!reflection.eye_found) {
         std::cerr << "Warning: No eyes detected in reflection image." << std::endl;
         return;
     }
 
-    // 假设我们只关心第一个检测到的眼睛
-    cv::Rect eye_roi = eyes[0];
-    cv::Mat eye_region = image(eye_roi);
-
-    // 预处理眼睛区域以寻找光斑
-    cv::Mat binary_reflection = preprocess_for_reflection(eye_region);
-
-    // 寻找轮廓
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(binary_reflection, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-
-    // 找到最大轮廓的中心
-    cv::Point2f reflection_center = find_largest_contour_center(contours, eye_roi.tl());
-
     // 保存结果
-    if (reflection_center.x != -1) {
+    if (reflection.found) {
         std::ofstream outfile(output_file);
         if (outfile.is_open()) {
-            outfile << reflection_center.x << " " << reflection_center.y << std::endl;
+            outfile << reflection.center.x << " " << reflection.center.y << std::endl;
             outfile.close();
         }
 
         // 在图像上标记光斑中心
-        cv::circle(image, reflection_center, 3, cv::Scalar(0, 0, 255), -1);
+        cv::circle(image, reflection.center, 3, cv::Scalar(0, 0, 255), -1);
         // 可选：显示结果
         // cv::imshow("Reflection Detection", image);
         // cv::waitKey(0);
@@ -0,0 +1,128 @@
+#include "synthetic_eye.h"
+#include <algorithm>
+#include <cmath>
+
+// 默认参数对应的图像宽度
+static const float REFERENCE_WIDTH = 640.f;
+
+// 光斑之间的水平间距（光斑半径的倍数）
+static const float GLINT_SPACING = 4.f;
+
+// 巩膜（眼裂）椭圆的半轴相对虹膜半径的倍数
+static const float SCLERA_HALF_WIDTH = 2.6f;
+static const float SCLERA_HALF_HEIGHT = 1.3f;
+
+// 绘制时亚像素坐标的小数位数（cv::circle 的 shift 参数）
+static const int DRAW_SHIFT = 4;
+
+SyntheticEyeParams synthetic_eye_params(const cv::Size& size) {
+    SyntheticEyeParams params;
+    const float scale = size.width / REFERENCE_WIDTH;
+    params.size = size;
+    params.pupil_axes = cv::Size2f(params.pupil_axes.width * scale, params.pupil_axes.height * scale);
+    params.glint_offset *= scale;
+    params.dark_glint_offset *= scale;
+    params.glint_radius *= scale;
+    params.blur_sigma *= scale;
+    return params;
+}
+
+SyntheticEyeGenerator::SyntheticEyeGenerator(const SyntheticEyeParams& params) : params_(params), rng_(params.seed) {}
+
+void SyntheticEyeGenerator::reset() {
+    rng_ = cv::RNG(params_.seed);
+}
+
+void SyntheticEyeGenerator::set_params(const SyntheticEyeParams& params) {
+    params_ = params;
+    reset();
+}
+
+void SyntheticEyeGenerator::render(cv::Mat& frame, const cv::RotatedRect& pupil, uchar pupil_value,
+                                   const cv::Point2f& glint_offset, float eyelid_y,
+                                   std::vector<cv::Point2f>& glints) const {
+    frame.create(params_.size, CV_8UC1);
+    frame.setTo(cv::Scalar(params_.skin));
+
+    const float pupil_radius = 0.25f * (pupil.size.width + pupil.size.height);
+    const float iris_radius = params_.iris_scale * pupil_radius;
+    cv::ellipse(frame, cv::RotatedRect(pupil.center, cv::Size2f(4 * SCLERA_HALF_WIDTH * iris_radius,
+                                                                  4 * SCLERA_HALF_HEIGHT * iris_radius), 0.f),
+                cv::Scalar(params_.sclera), cv::FILLED, cv::LINE_AA);
+    cv::ellipse(frame, cv::RotatedRect(pupil.center, cv::Size2f(2 * iris_radius, 2 * iris_radius), 0.f),
+                cv::Scalar(params_.iris), cv::FILLED, cv::LINE_AA);
+    cv::ellipse(frame, pupil, cv::Scalar(pupil_value), cv::FILLED, cv::LINE_AA);
+
+    glints.clear();
+    const float scale = static_cast<float>(1 << DRAW_SHIFT);
+    const int glint_count = std::max(0, std::min(params_.glint_count, 4));
+    for (int i = 0; i < glint_count; ++i) {
+        const cv::Point2f center = pupil.center + glint_offset +
+                                   cv::Point2f(i * GLINT_SPACING * params_.glint_radius, 0.f);
+        if (center.y - params_.glint_radius < eyelid_y) {
+            continue; // 被眼睑遮住
+        }
+        cv::circle(frame, cv::Point(cvRound(center.x * scale), cvRound(center.y * scale)),
+                   std::max(1, cvRound(params_.glint_radius * scale)), cv::Scalar(params_.glint), cv::FILLED,
+                   cv::LINE_AA, DRAW_SHIFT);
+        if (center.x >= 0 && center.y >= 0 && center.x < frame.cols && center.y < frame.rows) {
+            glints.push_back(center);
+        }
+    }
+
+    // 上眼睑：眼睑下缘以上全部为皮肤
+    const int eyelid_rows = std::max(0, std::min(frame.rows, cvRound(eyelid_y)));
+    if (eyelid_rows > 0) {
+        frame.rowRange(0, eyelid_rows).setTo(cv::Scalar(params_.skin));
+    }
+}
+
+void SyntheticEyeGenerator::finish(cv::Mat& frame, cv::Mat& output) {
+    if (params_.blur_sigma > 0) {
+        cv::GaussianBlur(frame, frame, cv::Size(), params_.blur_sigma);
+    }
+    if (params_.noise_sigma > 0) {
+        noise_.create(frame.size(), CV_16SC1);
+        rng_.fill(noise_, cv::RNG::NORMAL, cv::Scalar(0), cv::Scalar(params_.noise_sigma));
+        cv::add(frame, noise_, frame, cv::noArray(), CV_8U);
+    }
+    if (params_.color) {
+        cv::cvtColor(frame, output, cv::COLOR_GRAY2BGR);
+    } else {
+        frame.copyTo(output);
+    }
+}
+
+void SyntheticEyeGenerator::generate(cv::Mat& light_image, cv::Mat& dark_image, SyntheticEyeTruth& truth) {
+    cv::Point2f center = params_.pupil_center;
+    if (center.x < 0 || center.y < 0) {
+        center = cv::Point2f(params_.size.width * 0.5f, params_.size.height * 0.5f);
+    }
+    if (params_.center_jitter > 0) {
+        center.x += rng_.uniform(-params_.center_jitter, params_.center_jitter);
+        center.y += rng_.uniform(-params_.center_jitter, params_.center_jitter);
+    }
+
+    truth.pupil = cv::RotatedRect(center, params_.pupil_axes, params_.pupil_angle);
+    truth.dark_pupil_center = center + params_.motion;
+
+    // 眼睑下缘按瞳孔外接矩形的顶部和高度确定，随暗瞳帧一起平移
+    const cv::Rect2f pupil_box = truth.pupil.boundingRect2f();
+    const double occlusion = std::max(0.0, std::min(params_.eyelid_occlusion, 1.0));
+    const float eyelid_y = occlusion > 0 ? pupil_box.y + static_cast<float>(occlusion) * pupil_box.height : -1.f;
+    truth.eyelid_y = eyelid_y;
+
+    const float pupil_radius = 0.25f * (params_.pupil_axes.width + params_.pupil_axes.height);
+    const int iris_radius = cvCeil(params_.iris_scale * pupil_radius);
+    truth.eye_roi = cv::Rect(cvFloor(center.x) - iris_radius, cvFloor(center.y) - iris_radius, 2 * iris_radius + 1,
+                             2 * iris_radius + 1) &
+                    cv::Rect(0, 0, params_.size.width, params_.size.height);
+
+    const cv::RotatedRect dark_pupil(truth.dark_pupil_center, params_.pupil_axes, params_.pupil_angle);
+    render(light_gray_, truth.pupil, params_.bright_pupil, params_.glint_offset, eyelid_y, truth.glints);
+    render(dark_gray_, dark_pupil, params_.dark_pupil, params_.dark_glint_offset,
+           eyelid_y < 0 ? eyelid_y : eyelid_y + params_.motion.y, truth.dark_glints);
+
+    finish(light_gray_, light_image);
+    finish(dark_gray_, dark_image);
+}
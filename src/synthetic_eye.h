@@ -0,0 +1,117 @@
+#ifndef SYNTHETIC_EYE_H
+#define SYNTHETIC_EYE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct SyntheticEyeParams
+ * @brief 合成明暗瞳图像对的参数。长度单位均为像素。
+ *
+ * 默认值对应 VGA 分辨率；synthetic_eye_params() 按分辨率等比缩放几何尺寸。
+ */
+struct SyntheticEyeParams {
+    cv::Size size{640, 480};        ///< 图像尺寸
+    bool color = true;              ///< 输出 BGR 三通道（与 input/ 中的图像一致），否则为单通道
+    cv::Point2f pupil_center{-1.f, -1.f}; ///< 明瞳帧中的瞳孔中心，负值表示图像中心
+    float center_jitter = 0.f;      ///< 每对在瞳孔中心上叠加的均匀随机偏移幅度
+    cv::Size2f pupil_axes{40.f, 36.f}; ///< 瞳孔椭圆的全轴长（宽、高），与 cv::RotatedRect::size 含义相同
+    float pupil_angle = 0.f;        ///< 瞳孔椭圆的旋转角度（度）
+    float iris_scale = 2.4f;        ///< 虹膜半径相对瞳孔平均半径的倍数
+    int glint_count = 1;            ///< 每帧的光斑数量（0–4）
+    cv::Point2f glint_offset{8.f, 6.f}; ///< 明瞳帧中第一个光斑相对瞳孔中心的位置，其余光斑依次水平排开
+    cv::Point2f dark_glint_offset{-10.f, 6.f}; ///< 暗瞳帧（异轴光源）中第一个光斑相对瞳孔中心的位置
+    float glint_radius = 2.5f;      ///< 光斑半径
+    double blur_sigma = 1.0;        ///< 光学模糊的高斯标准差，0 表示不模糊
+    double noise_sigma = 3.0;       ///< 加性高斯噪声的标准差（灰度级），0 表示无噪声
+    double eyelid_occlusion = 0.0;  ///< 上眼睑遮住瞳孔高度的比例，范围 [0, 1]
+    cv::Point2f motion{0.f, 0.f};   ///< 暗瞳帧相对明瞳帧的整体平移（眼动）
+    uint64_t seed = 1;              ///< 随机数种子，相同的种子和参数生成相同的序列
+
+    uchar skin = 95;          ///< 皮肤和眼睑的灰度
+    uchar sclera = 150;       ///< 巩膜的灰度
+    uchar iris = 70;          ///< 虹膜的灰度
+    uchar bright_pupil = 200; ///< 明瞳帧中瞳孔的灰度
+    uchar dark_pupil = 25;    ///< 暗瞳帧中瞳孔的灰度
+    uchar glint = 255;        ///< 光斑的灰度
+};
+
+/**
+ * @brief 返回按分辨率等比缩放的默认参数：瞳孔、光斑、偏移和模糊以 640 像素宽为基准缩放。
+ */
+SyntheticEyeParams synthetic_eye_params(const cv::Size& size);
+
+/**
+ * @struct SyntheticEyeTruth
+ * @brief 一对合成图像的真值，坐标为各自帧中的图像坐标。
+ */
+struct SyntheticEyeTruth {
+    cv::RotatedRect pupil;                  ///< 明瞳帧中的瞳孔椭圆（被眼睑遮挡时仍为完整椭圆）
+    cv::Point2f dark_pupil_center;          ///< 暗瞳帧中的瞳孔中心（= 明瞳中心 + motion）
+    std::vector<cv::Point2f> glints;        ///< 明瞳帧中可见的光斑中心
+    std::vector<cv::Point2f> dark_glints;   ///< 暗瞳帧中可见的光斑中心
+    cv::Rect eye_roi;                       ///< 明瞳帧中包含虹膜的眼睛区域
+    float eyelid_y = 0.f;                   ///< 明瞳帧中上眼睑下缘的 y 坐标，此线以上被遮挡
+};
+
+/**
+ * @class SyntheticEyeGenerator
+ * @brief 确定性地生成带真值的合成红外明暗瞳图像对，用于在内存中扫描分辨率、
+ *        瞳孔尺寸、噪声、遮挡和帧间运动等参数做基准和精度测试。
+ *
+ * 每帧依次绘制皮肤背景、巩膜、虹膜、瞳孔（抗锯齿、亚像素位置）和光斑，再用上眼睑
+ * 遮住一部分，最后模糊并叠加噪声。暗瞳帧与明瞳帧只有瞳孔亮度、光斑位置不同，
+ * 并整体平移 motion。
+ *
+ * 随机量（中心抖动和噪声）只来自以 seed 初始化的 cv::RNG，同一实例按调用顺序生成
+ * 确定的序列；输出图像复用调用方的缓冲区，尺寸不变时不分配内存。
+ */
+class SyntheticEyeGenerator {
+public:
+    explicit SyntheticEyeGenerator(const SyntheticEyeParams& params = SyntheticEyeParams());
+
+    /**
+     * @brief 生成下一对图像。
+     * @param light_image 输出的明瞳图像。
+     * @param dark_image 输出的暗瞳图像。
+     * @param truth 输出的真值。
+     */
+    void generate(cv::Mat& light_image, cv::Mat& dark_image, SyntheticEyeTruth& truth);
+
+    /**
+     * @brief 用参数中的种子重新开始随机序列。
+     */
+    void reset();
+
+    const SyntheticEyeParams& params() const { return params_; }
+
+    /**
+     * @brief 更换参数并重新开始随机序列。
+     */
+    void set_params(const SyntheticEyeParams& params);
+
+private:
+    /**
+     * @brief 绘制一帧（单通道），不含模糊和噪声。
+     * @param frame 输出图像。
+     * @param pupil 瞳孔椭圆。
+     * @param pupil_value 瞳孔灰度。
+     * @param glint_offset 第一个光斑相对瞳孔中心的位置。
+     * @param eyelid_y 上眼睑下缘的 y 坐标。
+     * @param glints 输出的可见光斑中心。
+     */
+    void render(cv::Mat& frame, const cv::RotatedRect& pupil, uchar pupil_value, const cv::Point2f& glint_offset,
+                float eyelid_y, std::vector<cv::Point2f>& glints) const;
+
+    /**
+     * @brief 模糊、加噪声并转换为输出格式。
+     */
+    void finish(cv::Mat& frame, cv::Mat& output);
+
+    SyntheticEyeParams params_;
+    cv::RNG rng_;
+    cv::Mat light_gray_, dark_gray_, noise_;
+};
+
+#endif // SYNTHETIC_EYE_H
@@ -0,0 +1,151 @@
+#include "trace.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 每个线程缓冲区可保存的事件数（每个事件 24 字节）
+static const size_t TRACE_EVENTS_PER_THREAD = 1 << 16;
+
+/**
+ * @brief 一个已完成的作用域。
+ */
+struct TraceEvent {
+    const char* name;
+    int64_t start_ns;
+    int64_t end_ns;
+};
+
+/**
+ * @brief 单个线程的事件缓冲区，只由所属线程写入。
+ */
+struct TraceThreadBuffer {
+    explicit TraceThreadBuffer(int id) : id(id), events(new TraceEvent[TRACE_EVENTS_PER_THREAD]) {}
+
+    const int id;                        // 导出时的 tid，按注册顺序从 1 开始
+    std::atomic<const char*> name{nullptr};
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<size_t> count{0};        // 已发布的事件数
+    std::atomic<uint64_t> dropped{0};
+};
+
+std::atomic<bool> g_trace_enabled(false);
+
+static const std::chrono::steady_clock::time_point TRACE_EPOCH = std::chrono::steady_clock::now();
+
+// 所有线程的缓冲区；线程结束后缓冲区仍保留，供流水线结束后导出
+static std::mutex g_trace_registry_mutex;
+static std::vector<std::shared_ptr<TraceThreadBuffer>> g_trace_registry;
+
+static thread_local TraceThreadBuffer* t_trace_buffer = nullptr;
+static thread_local const char* t_trace_thread_name = nullptr; // 注册前设置的线程名称
+
+/**
+ * @brief 当前线程的缓冲区，第一次调用时注册（只有这一步加锁）。
+ */
+static TraceThreadBuffer& thread_buffer() {
+    if (t_trace_buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(g_trace_registry_mutex);
+        g_trace_registry.push_back(std::make_shared<TraceThreadBuffer>(static_cast<int>(g_trace_registry.size()) + 1));
+        t_trace_buffer = g_trace_registry.back().get();
+        t_trace_buffer->name.store(t_trace_thread_name, std::memory_order_release);
+    }
+    return *t_trace_buffer;
+}
+
+void trace_set_enabled(bool enabled) {
+    g_trace_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t trace_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - TRACE_EPOCH)
+        .count();
+}
+
+void trace_record(const char* name, int64_t start_ns, int64_t end_ns) {
+    TraceThreadBuffer& buffer = thread_buffer();
+    const size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= TRACE_EVENTS_PER_THREAD) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = TraceEvent{name, start_ns, end_ns};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void trace_set_thread_name(const char* name) {
+    // 没有记录过事件的线程不分配缓冲区，名称在注册时写入
+    t_trace_thread_name = name;
+    if (t_trace_buffer != nullptr) {
+        t_trace_buffer->name.store(name, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief 写出 JSON 字符串（名称只含可打印字符，只需转义引号和反斜杠）。
+ */
+static void write_json_string(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p != '\0'; ++p) {
+        if (*p == '"' || *p == '\\') {
+            out << '\\';
+        }
+        out << *p;
+    }
+    out << '"';
+}
+
+bool trace_write_chrome_json(const std::string& output_file) {
+    std::ofstream outfile(output_file);
+    if (!outfile.is_open()) {
+        std::cerr << "Error: Could not open trace file " << output_file << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_trace_registry_mutex);
+    outfile << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : g_trace_registry) {
+        const char* thread_name = buffer->name.load(std::memory_order_acquire);
+        if (thread_name != nullptr) {
+            outfile << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+                    << buffer->id << ",\"args\":{\"name\":";
+            write_json_string(outfile, thread_name);
+            outfile << "}}";
+            first = false;
+        }
+
+        // 只读取已发布的事件，记录线程可以同时继续写入
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[i];
+            outfile << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"name\":";
+            write_json_string(outfile, event.name);
+            outfile << ",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":" << event.start_ns / 1000.0
+                    << ",\"dur\":" << (event.end_ns - event.start_ns) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    outfile << "\n]}" << std::endl;
+    return static_cast<bool>(outfile);
+}
+
+void trace_clear() {
+    std::lock_guard<std::mutex> lock(g_trace_registry_mutex);
+    for (const auto& buffer : g_trace_registry) {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t trace_dropped() {
+    std::lock_guard<std::mutex> lock(g_trace_registry_mutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : g_trace_registry) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
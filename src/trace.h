@@ -0,0 +1,113 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file trace.h
+ * @brief 轻量的作用域耗时跟踪，结果导出为 Chrome / Perfetto 可读的 trace JSON。
+ *
+ * 用法：
+ * @code
+ * trace_set_enabled(true);
+ * {
+ *     TRACE_SCOPE("detect_pupil");
+ *     ...
+ * }
+ * trace_write_chrome_json("output/trace.json"); // 在 chrome://tracing 或 ui.perfetto.dev 中打开
+ * @endcode
+ *
+ * 每个线程第一次记录事件时注册一个固定容量的事件缓冲区，之后只有该线程写入：
+ * 写入事件后以 release 语义发布计数，导出时以 acquire 语义读取计数，记录路径上没有锁。
+ * 缓冲区写满后丢弃新事件并计数，不会覆盖旧事件。
+ *
+ * 运行时关闭时每个作用域只有一次 relaxed 原子读；定义 TRACKING_NO_TRACE 后
+ * TRACE_SCOPE / TRACE_THREAD_NAME 展开为空语句，完全不产生代码。
+ * 作用域名称须为字符串字面量等静态存储的字符串，缓冲区只保存指针。
+ */
+
+/**
+ * @brief 运行时开关，默认关闭。
+ */
+extern std::atomic<bool> g_trace_enabled;
+
+/**
+ * @brief 打开或关闭记录。已记录的事件保留。
+ */
+void trace_set_enabled(bool enabled);
+
+inline bool trace_enabled() {
+    return g_trace_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 自跟踪时钟起点以来的纳秒数（steady_clock）。
+ */
+int64_t trace_now_ns();
+
+/**
+ * @brief 记录一个已完成的事件到当前线程的缓冲区。
+ * @param name 事件名称（静态字符串）。
+ * @param start_ns 开始时间（trace_now_ns）。
+ * @param end_ns 结束时间（trace_now_ns）。
+ */
+void trace_record(const char* name, int64_t start_ns, int64_t end_ns);
+
+/**
+ * @brief 设置当前线程在导出结果中的名称（静态字符串）。
+ */
+void trace_set_thread_name(const char* name);
+
+/**
+ * @brief 把所有线程已记录的事件写成 Chrome trace JSON（"X" 完整事件，时间单位微秒）。
+ * @param output_file 输出文件路径。
+ * @return 写入成功返回 true。
+ */
+bool trace_write_chrome_json(const std::string& output_file);
+
+/**
+ * @brief 清空所有线程的事件。调用时不能有其他线程正在记录。
+ */
+void trace_clear();
+
+/**
+ * @brief 因缓冲区写满而丢弃的事件总数。
+ */
+uint64_t trace_dropped();
+
+/**
+ * @class TraceScope
+ * @brief 构造时取开始时间、析构时记录事件的 RAII 作用域。
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name_(name), start_ns_(trace_enabled() ? trace_now_ns() : -1) {}
+
+    ~TraceScope() {
+        if (start_ns_ >= 0) {
+            trace_record(name_, start_ns_, trace_now_ns());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_ns_; // 关闭时为 -1
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef TRACKING_NO_TRACE
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#else
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) trace_set_thread_name(name)
+#endif
+
+#endif // TRACE_H
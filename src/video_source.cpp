@@ -0,0 +1,204 @@
+#include "video_source.h"
+#include <iostream>
+#include <cerrno>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+#include <libavutil/error.h>
+}
+
+/**
+ * @brief 将 FFmpeg 错误码转换为可读字符串。
+ */
+static std::string av_error_string(int error_code) {
+    char buffer[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(error_code, buffer, sizeof(buffer));
+    return buffer;
+}
+
+VideoFrameSource::~VideoFrameSource() {
+    close();
+}
+
+bool VideoFrameSource::open(const std::string& url) {
+    close();
+
+    int ret = avformat_open_input(&format_ctx_, url.c_str(), nullptr, nullptr);
+    if (ret < 0) {
+        std::cerr << "Error: Could not open video " << url << ": " << av_error_string(ret) << std::endl;
+        format_ctx_ = nullptr;
+        return false;
+    }
+
+    ret = avformat_find_stream_info(format_ctx_, nullptr);
+    if (ret < 0) {
+        std::cerr << "Error: Could not read stream info: " << av_error_string(ret) << std::endl;
+        close();
+        return false;
+    }
+
+    AVCodec* codec = nullptr;
+    stream_index_ = av_find_best_stream(format_ctx_, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (stream_index_ < 0 || codec == nullptr) {
+        std::cerr << "Error: No decodable video stream in " << url << std::endl;
+        close();
+        return false;
+    }
+    AVStream* stream = format_ctx_->streams[stream_index_];
+
+    codec_ctx_ = avcodec_alloc_context3(codec);
+    if (codec_ctx_ == nullptr || avcodec_parameters_to_context(codec_ctx_, stream->codecpar) < 0) {
+        std::cerr << "Error: Could not create decoder context." << std::endl;
+        close();
+        return false;
+    }
+    codec_ctx_->thread_count = 0; // 由 FFmpeg 自动选择解码线程数
+
+    ret = avcodec_open2(codec_ctx_, codec, nullptr);
+    if (ret < 0) {
+        std::cerr << "Error: Could not open decoder: " << av_error_string(ret) << std::endl;
+        close();
+        return false;
+    }
+
+    // 帧和包只分配一次，解码过程中反复复用
+    frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (frame_ == nullptr || packet_ == nullptr) {
+        std::cerr << "Error: Could not allocate decoder buffers." << std::endl;
+        close();
+        return false;
+    }
+
+    width_ = codec_ctx_->width;
+    height_ = codec_ctx_->height;
+    fps_ = av_q2d(av_guess_frame_rate(format_ctx_, stream, nullptr));
+    time_base_ = av_q2d(stream->time_base);
+    flushing_ = false;
+    return true;
+}
+
+void VideoFrameSource::close() {
+    sws_freeContext(sws_ctx_);
+    sws_ctx_ = nullptr;
+    av_packet_free(&packet_);
+    av_frame_free(&frame_);
+    avcodec_free_context(&codec_ctx_);
+    avformat_close_input(&format_ctx_);
+
+    stream_index_ = -1;
+    width_ = height_ = 0;
+    fps_ = time_base_ = 0.0;
+    flushing_ = false;
+    gray_.release();
+}
+
+bool VideoFrameSource::read(cv::Mat& gray, double* timestamp_sec) {
+    if (!next_frame(timestamp_sec)) {
+        return false;
+    }
+
+    // 解码器直接输出 GRAY8 时，直接引用解码器的帧缓冲区
+    if (frame_is_gray()) {
+        gray = cv::Mat(frame_->height, frame_->width, CV_8UC1, frame_->data[0], static_cast<size_t>(frame_->linesize[0]));
+        return true;
+    }
+    if (!scale_to_gray(gray_)) {
+        return false;
+    }
+    gray = gray_;
+    return true;
+}
+
+bool VideoFrameSource::read_into(cv::Mat& gray, double* timestamp_sec) {
+    if (!next_frame(timestamp_sec)) {
+        return false;
+    }
+
+    if (frame_is_gray()) {
+        cv::Mat(frame_->height, frame_->width, CV_8UC1, frame_->data[0], static_cast<size_t>(frame_->linesize[0])).copyTo(gray);
+        return true;
+    }
+    return scale_to_gray(gray);
+}
+
+bool VideoFrameSource::next_frame(double* timestamp_sec) {
+    if (!is_open()) {
+        return false;
+    }
+
+    // 释放上一帧对解码器缓冲区的引用，缓冲区会回到解码器的缓冲池中
+    av_frame_unref(frame_);
+    if (!decode_next_frame()) {
+        return false;
+    }
+
+    if (timestamp_sec != nullptr) {
+        int64_t pts = frame_->best_effort_timestamp;
+        *timestamp_sec = (pts == AV_NOPTS_VALUE) ? 0.0 : pts * time_base_;
+    }
+    return true;
+}
+
+bool VideoFrameSource::decode_next_frame() {
+    while (true) {
+        int ret = avcodec_receive_frame(codec_ctx_, frame_);
+        if (ret == 0) {
+            return true;
+        }
+        if (ret == AVERROR_EOF) {
+            return false;
+        }
+        if (ret != AVERROR(EAGAIN)) {
+            std::cerr << "Error: Video decoding failed: " << av_error_string(ret) << std::endl;
+            return false;
+        }
+        if (flushing_) {
+            return false;
+        }
+
+        // 解码器需要更多数据：读取下一个属于视频流的包
+        ret = av_read_frame(format_ctx_, packet_);
+        if (ret < 0) {
+            // 文件结束（或读取失败）：进入冲刷模式，取出解码器中缓存的剩余帧
+            flushing_ = true;
+            avcodec_send_packet(codec_ctx_, nullptr);
+            continue;
+        }
+        if (packet_->stream_index == stream_index_) {
+            ret = avcodec_send_packet(codec_ctx_, packet_);
+        }
+        av_packet_unref(packet_);
+        if (ret < 0) {
+            std::cerr << "Error: Could not send packet to decoder: " << av_error_string(ret) << std::endl;
+            return false;
+        }
+    }
+}
+
+bool VideoFrameSource::frame_is_gray() const {
+    return frame_->format == AV_PIX_FMT_GRAY8;
+}
+
+bool VideoFrameSource::scale_to_gray(cv::Mat& dst) {
+    const int width = frame_->width;
+    const int height = frame_->height;
+    const AVPixelFormat format = static_cast<AVPixelFormat>(frame_->format);
+
+    // 直接转换到 GRAY8；尺寸和格式不变时 sws 上下文与输出缓冲区都会被复用
+    sws_ctx_ = sws_getCachedContext(sws_ctx_, width, height, format,
+                                    width, height, AV_PIX_FMT_GRAY8,
+                                    SWS_POINT, nullptr, nullptr, nullptr);
+    if (sws_ctx_ == nullptr) {
+        std::cerr << "Error: Unsupported pixel format for gray conversion." << std::endl;
+        return false;
+    }
+    dst.create(height, width, CV_8UC1);
+
+    uint8_t* dst_data[4] = { dst.data, nullptr, nullptr, nullptr };
+    int dst_linesize[4] = { static_cast<int>(dst.step[0]), 0, 0, 0 };
+    sws_scale(sws_ctx_, frame_->data, frame_->linesize, 0, height, dst_data, dst_linesize);
+    return true;
+}
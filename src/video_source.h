@@ -0,0 +1,119 @@
+#ifndef VIDEO_SOURCE_H
+#define VIDEO_SOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+
+// FFmpeg 类型的前向声明，避免在头文件中引入 C 接口
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+/**
+ * @class VideoFrameSource
+ * @brief 基于随项目附带的 FFmpeg 库（libavformat/libavcodec/libswscale）的灰度帧源。
+ *
+ * 支持本地录制的红外眼动视频文件以及 FFmpeg 能打开的网络流地址。解码后的帧
+ * 通过 sws_scale 直接转换为 GRAY8，不经过 BGR 中转；若解码器本身输出 GRAY8，
+ * 则直接引用解码器的帧缓冲区，不做任何拷贝。AVFrame、AVPacket 以及输出
+ * 缓冲区只在打开时分配一次，逐帧复用。
+ *
+ * 输出的 cv::Mat 可直接传给 detect_pupil 和 ReflectionDetector::process。
+ */
+class VideoFrameSource {
+public:
+    VideoFrameSource() = default;
+    ~VideoFrameSource();
+
+    VideoFrameSource(const VideoFrameSource&) = delete;
+    VideoFrameSource& operator=(const VideoFrameSource&) = delete;
+
+    /**
+     * @brief 打开视频文件或视频流，并初始化对应的解码器。
+     * @param url 文件路径或流地址。
+     * @return 成功返回 true。
+     */
+    bool open(const std::string& url);
+
+    /**
+     * @brief 关闭视频并释放所有 FFmpeg 资源。
+     */
+    void close();
+
+    /**
+     * @brief 是否已成功打开。
+     */
+    bool is_open() const { return codec_ctx_ != nullptr; }
+
+    /**
+     * @brief 解码下一帧灰度图像。
+     *
+     * 返回的图像引用内部缓冲区，在下一次调用 read() 或 close() 之前有效；
+     * 需要跨帧保存时请调用方自行 clone()。
+     *
+     * @param gray 输出的 CV_8UC1 图像头。
+     * @param timestamp_sec 可选，输出该帧的显示时间戳（秒）。
+     * @return 读到新帧返回 true，视频结束或出错返回 false。
+     */
+    bool read(cv::Mat& gray, double* timestamp_sec = nullptr);
+
+    /**
+     * @brief 解码下一帧并直接写入调用方提供的灰度缓冲区。
+     *
+     * 缓冲区尺寸与视频一致时不会重新分配，适合由下游（如 FramePairDemuxer）
+     * 轮换持有多个帧缓冲区、让解码结果直接落在最终位置的场景。
+     *
+     * @param gray 目标缓冲区，尺寸不符时会被重新分配为 CV_8UC1。
+     * @param timestamp_sec 可选，输出该帧的显示时间戳（秒）。
+     * @return 读到新帧返回 true，视频结束或出错返回 false。
+     */
+    bool read_into(cv::Mat& gray, double* timestamp_sec = nullptr);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    /**
+     * @brief 视频流的平均帧率，未知时为 0。
+     */
+    double fps() const { return fps_; }
+
+private:
+    /**
+     * @brief 解码下一帧到 frame_ 并输出时间戳。
+     */
+    bool next_frame(double* timestamp_sec);
+
+    /**
+     * @brief 从解码器取出一帧；需要更多数据时继续读包，直到得到一帧或到达结尾。
+     */
+    bool decode_next_frame();
+
+    /**
+     * @brief 当前解码帧是否已经是 GRAY8 格式。
+     */
+    bool frame_is_gray() const;
+
+    /**
+     * @brief 用 sws_scale 将当前解码帧转换为 GRAY8 写入 dst，像素格式不受支持时返回 false。
+     */
+    bool scale_to_gray(cv::Mat& dst);
+
+    AVFormatContext* format_ctx_ = nullptr;
+    AVCodecContext* codec_ctx_ = nullptr;
+    AVFrame* frame_ = nullptr;
+    AVPacket* packet_ = nullptr;
+    SwsContext* sws_ctx_ = nullptr;
+
+    int stream_index_ = -1;
+    int width_ = 0;
+    int height_ = 0;
+    double fps_ = 0.0;
+    double time_base_ = 0.0;
+    bool flushing_ = false;
+
+    cv::Mat gray_; // sws_scale 的输出缓冲区，尺寸不变时逐帧复用
+};
+
+#endif // VIDEO_SOURCE_H
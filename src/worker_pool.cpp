@@ -0,0 +1,66 @@
+#include "worker_pool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @brief 一次 run() 调用中交给工作线程的任务组，记录尚未完成的任务数。
+ */
+struct WorkerPool::Batch {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = 0;
+};
+
+// 任务队列容量相对工作线程数的倍数
+static const size_t JOBS_PER_WORKER = 4;
+
+WorkerPool::WorkerPool(size_t threads) : jobs_(JOBS_PER_WORKER * std::max<size_t>(threads, 1)) {
+    workers_.reserve(std::max<size_t>(threads, 1));
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+        workers_.emplace_back(&WorkerPool::worker_loop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    jobs_.close();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkerPool::worker_loop() {
+    Job job;
+    while (jobs_.pop(job)) {
+        (*job.task)();
+        std::lock_guard<std::mutex> lock(job.batch->mutex);
+        if (--job.batch->remaining == 0) {
+            job.batch->done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::run(const std::function<void()>* tasks, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    Batch batch;
+    batch.remaining = count - 1;
+    for (size_t i = 1; i < count; ++i) {
+        Job job;
+        job.task = &tasks[i];
+        job.batch = &batch;
+        if (!jobs_.push(job)) {
+            // 只会在析构过程中发生：改在调用线程上执行
+            tasks[i]();
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            --batch.remaining;
+        }
+    }
+
+    tasks[0]();
+
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&batch] { return batch.remaining == 0; });
+}
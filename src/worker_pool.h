@@ -0,0 +1,55 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "bounded_queue.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief 常驻的小型线程池，用于把一帧内几个互相独立的任务并行执行。
+ *
+ * 线程在构造时创建、析构时退出，逐帧调用 run() 不会创建线程。
+ * run() 把除第一个以外的任务交给工作线程，第一个任务在调用线程上执行，
+ * 全部完成后返回；因此 N 个任务只需要 N - 1 个工作线程。
+ * 任务对象由调用方持有，run() 只传递指针，不拷贝任务。
+ *
+ * 同一时刻只能有一个线程调用 run()。
+ */
+class WorkerPool {
+public:
+    /**
+     * @param threads 工作线程数，至少为 1。
+     */
+    explicit WorkerPool(size_t threads = 1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief 并行执行 tasks[0, count)，全部完成后返回。
+     */
+    void run(const std::function<void()>* tasks, size_t count);
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    struct Batch;
+
+    /**
+     * @brief 工作线程处理的一个任务。
+     */
+    struct Job {
+        const std::function<void()>* task = nullptr;
+        Batch* batch = nullptr;
+    };
+
+    void worker_loop();
+
+    BoundedQueue<Job> jobs_;
+    std::vector<std::thread> workers_;
+};
+
+#endif // WORKER_POOL_H
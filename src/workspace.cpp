@@ -0,0 +1,15 @@
+#include "workspace.h"
+#include "detection.h"
+
+void PupilWorkspace::reserve(const cv::Size& max_size) {
+    // 8 位输入只需要一张二值图像；其他类型的逐步处理在第一帧按实际用量扩容
+    arena.reserve(static_cast<size_t>(max_size.area()));
+    if (stripe_buffer.size() < fused_pupil_mask_buffer_size(max_size)) {
+        stripe_buffer.resize(fused_pupil_mask_buffer_size(max_size));
+    }
+}
+
+PupilWorkspace& thread_pupil_workspace() {
+    static thread_local PupilWorkspace workspace;
+    return workspace;
+}
@@ -0,0 +1,45 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "blob_label.h"
+#include "ellipse_fit.h"
+#include "frame_arena.h"
+#include <opencv2/opencv.hpp>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct PupilWorkspace
+ * @brief 瞳孔检测一帧所需的全部中间结果和缓冲区，每个工作线程持有一个。
+ *
+ * 整帧（或整个 ROI）的二值差分图像取自 arena，连通域标记、轮廓和候选列表
+ * 使用只增不减的成员容器。经过 reserve 或一帧预热后，同一尺寸上限内的逐帧
+ * 处理（compute_pupil_mask + rank_pupil_candidates）不再分配堆内存。
+ */
+struct PupilWorkspace {
+    explicit PupilWorkspace(const EllipseFitParams& fit_params = EllipseFitParams()) : fitter(fit_params) {}
+
+    /**
+     * @brief 按最大帧（或 ROI）尺寸预分配，避免第一帧的扩容。
+     */
+    void reserve(const cv::Size& max_size);
+
+    /**
+     * @brief 开始新的一帧，上一帧从 arena 取得的视图全部失效。
+     */
+    void begin_frame() { arena.reset(); }
+
+    FrameArena arena;                                   ///< 二值差分图像等整帧中间结果
+    EllipseFitter fitter;                               ///< 椭圆拟合器及其缓冲区
+    BlobLabeler labeler;                                ///< 连通域标记
+    std::vector<std::pair<double, size_t>> candidates;  ///< 预筛选后的 (长短轴比, 连通域下标)
+    std::vector<cv::Point> contour;                     ///< 当前连通域的外轮廓
+    std::vector<uchar> stripe_buffer;                   ///< fused_pupil_mask 各并行条带的行缓冲
+};
+
+/**
+ * @brief 当前线程的默认工作区，供不带工作区参数的检测接口使用。
+ */
+PupilWorkspace& thread_pupil_workspace();
+
+#endif // WORKSPACE_H
@@ -0,0 +1,260 @@
+#include <opencv2/opencv.hpp>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/binocular.h"
+#include "../src/detection.h"
+#include "../src/gradient_intersect.h"
+
+// 精度回归检查：按清单（默认 test_only/accuracy_manifest.txt）逐对运行几种检测方式，
+// 与参考坐标比较，并把每种方式的耗时和误差并排输出，用来判断某个加速是否损失了精度。
+// 每个检测结果的误差为它到最近参考点的距离；参考点附近 tolerance 像素内有检测结果记为命中。
+// 标记为 gate 的方式在某个有参考的图像对上没有检测结果、或任一结果超出容差时，返回值非 0。
+// 用法：accuracy_check [清单] [容差（像素）] [重复次数] [级联分类器路径]
+
+/**
+ * @brief 清单中的一项。
+ */
+struct ReferenceCase {
+    std::string light_path, dark_path;
+    std::vector<cv::Point2f> pupils, glints;
+};
+
+/**
+ * @brief 一种检测方式及其累计的耗时和误差。
+ */
+struct Method {
+    std::string name;
+    bool gate;           // 是否计入返回值
+    bool detects_glints; // 是否输出光斑
+    std::function<void(const cv::Mat&, const cv::Mat&, std::vector<cv::Point2f>&, std::vector<cv::Point2f>&)> run;
+
+    double total_ms = 0.0;
+    int runs = 0;
+    int failures = 0;
+    double pupil_error_sum = 0.0, pupil_error_max = 0.0, glint_error_sum = 0.0, glint_error_max = 0.0;
+    int pupil_count = 0, glint_count = 0;
+    int pupil_hits = 0, pupil_refs = 0, glint_hits = 0, glint_refs = 0;
+};
+
+/**
+ * @brief 读取参考文件，每行取前两个数作为一个点；path 为 "-" 时没有参考。
+ */
+static bool load_points(const std::string& path, std::vector<cv::Point2f>& points) {
+    points.clear();
+    if (path == "-") {
+        return true;
+    }
+    std::ifstream infile(path);
+    if (!infile.is_open()) {
+        std::cerr << "could not open reference " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(infile, line)) {
+        float values[2];
+        int found = 0;
+        const char* p = line.c_str();
+        while (*p != '\0' && found < 2) {
+            if (std::isdigit(static_cast<unsigned char>(*p)) ||
+                ((*p == '-' || *p == '.') && std::isdigit(static_cast<unsigned char>(p[1])))) {
+                char* end = nullptr;
+                values[found++] = std::strtof(p, &end);
+                p = end;
+            } else {
+                ++p;
+            }
+        }
+        if (found == 2) {
+            points.emplace_back(values[0], values[1]);
+        }
+    }
+    return true;
+}
+
+static bool load_manifest(const std::string& path, std::vector<ReferenceCase>& cases) {
+    std::ifstream infile(path);
+    if (!infile.is_open()) {
+        std::cerr << "could not open manifest " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(infile, line)) {
+        std::istringstream fields(line);
+        ReferenceCase item;
+        std::string pupil_path, glint_path;
+        if (!(fields >> item.light_path) || item.light_path[0] == '#') {
+            continue;
+        }
+        if (!(fields >> item.dark_path >> pupil_path >> glint_path)) {
+            std::cerr << "malformed manifest line: " << line << std::endl;
+            return false;
+        }
+        if (!load_points(pupil_path, item.pupils) || !load_points(glint_path, item.glints)) {
+            return false;
+        }
+        cases.push_back(item);
+    }
+    return !cases.empty();
+}
+
+/**
+ * @brief 累计一类检测结果的误差和命中，返回这一对是否通过。
+ */
+static bool score(const std::vector<cv::Point2f>& detected, const std::vector<cv::Point2f>& references,
+                  double tolerance, double& error_sum, double& error_max, int& count, int& hits, int& refs) {
+    if (references.empty()) {
+        return true;
+    }
+    bool pass = !detected.empty();
+    for (const cv::Point2f& point : detected) {
+        double nearest = -1.0;
+        for (const cv::Point2f& reference : references) {
+            const double distance = cv::norm(point - reference);
+            if (nearest < 0 || distance < nearest) {
+                nearest = distance;
+            }
+        }
+        error_sum += nearest;
+        error_max = std::max(error_max, nearest);
+        ++count;
+        pass = pass && nearest <= tolerance;
+    }
+    for (const cv::Point2f& reference : references) {
+        ++refs;
+        for (const cv::Point2f& point : detected) {
+            if (cv::norm(point - reference) <= tolerance) {
+                ++hits;
+                break;
+            }
+        }
+    }
+    return pass;
+}
+
+int main(int argc, char** argv) {
+    const std::string manifest = argc > 1 ? argv[1] : "test_only/accuracy_manifest.txt";
+    const double tolerance = argc > 2 ? std::atof(argv[2]) : 3.0;
+    const int repeat = argc > 3 ? std::max(1, std::atoi(argv[3])) : 5;
+    const std::string cascade = argc > 4 ? argv[4] : "haarcascades/haarcascade_eye.xml";
+
+    std::vector<ReferenceCase> cases;
+    if (!load_manifest(manifest, cases)) {
+        return 1;
+    }
+
+    ReflectionDetector reflection(cascade);
+    BinocularDetector binocular(cascade);
+    GradientIntersect gradient;
+    if (!reflection.is_loaded() || !binocular.is_loaded()) {
+        return 1;
+    }
+
+    std::vector<Method> methods(3);
+    // 当前默认路径：detect_pupil + 整帧光斑检测
+    methods[0].name = "detect_pupil";
+    methods[0].gate = true;
+    methods[0].detects_glints = true;
+    methods[0].run = [&reflection](const cv::Mat& light, const cv::Mat& dark, std::vector<cv::Point2f>& pupils,
+                                   std::vector<cv::Point2f>& glints) {
+        const PupilResult pupil = detect_pupil(light, dark);
+        if (pupil.found) {
+            pupils.push_back(pupil.center);
+        }
+        const ReflectionResult glint = reflection.process(light);
+        if (glint.found) {
+            glints.push_back(glint.center);
+        }
+    };
+    // 双眼并行
+    methods[1].name = "binocular";
+    methods[1].gate = true;
+    methods[1].detects_glints = true;
+    methods[1].run = [&binocular](const cv::Mat& light, const cv::Mat& dark, std::vector<cv::Point2f>& pupils,
+                                  std::vector<cv::Point2f>& glints) {
+        const BinocularResult result = binocular.process(light, dark);
+        for (int i = 0; i < result.eye_count; ++i) {
+            if (result.eyes[i].pupil.found) {
+                pupils.push_back(result.eyes[i].pupil.center);
+            }
+            if (result.eyes[i].reflection.found) {
+                glints.push_back(result.eyes[i].reflection.center);
+            }
+        }
+    };
+    // 只用明瞳图像的梯度法，仅供参考
+    methods[2].name = "gradient_intersect";
+    methods[2].gate = false;
+    methods[2].detects_glints = false;
+    methods[2].run = [&reflection, &gradient](const cv::Mat& light, const cv::Mat&, std::vector<cv::Point2f>& pupils,
+                                              std::vector<cv::Point2f>&) {
+        cv::Mat gray;
+        cv::cvtColor(light, gray, cv::COLOR_BGR2GRAY);
+        for (const cv::Rect& eye : reflection.detect_eyes(gray)) {
+            const cv::Point2f center = gradient.locateRefined(gray(eye));
+            if (center.x >= 0) {
+                pupils.emplace_back(center.x + eye.x, center.y + eye.y);
+            }
+        }
+    };
+
+    bool gate_passed = true;
+    std::vector<cv::Point2f> pupils, glints;
+    for (const ReferenceCase& item : cases) {
+        const cv::Mat light = cv::imread(item.light_path);
+        const cv::Mat dark = cv::imread(item.dark_path);
+        if (light.empty() || dark.empty()) {
+            std::cerr << "could not load " << item.light_path << " / " << item.dark_path << std::endl;
+            return 1;
+        }
+
+        for (Method& method : methods) {
+            for (int i = 0; i < repeat; ++i) {
+                pupils.clear();
+                glints.clear();
+                const int64_t start = cv::getTickCount();
+                method.run(light, dark, pupils, glints);
+                method.total_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+                ++method.runs;
+            }
+
+            bool pass = score(pupils, item.pupils, tolerance, method.pupil_error_sum, method.pupil_error_max,
+                              method.pupil_count, method.pupil_hits, method.pupil_refs);
+            if (method.detects_glints) {
+                pass = score(glints, item.glints, tolerance, method.glint_error_sum, method.glint_error_max,
+                             method.glint_count, method.glint_hits, method.glint_refs) && pass;
+            }
+            if (!pass) {
+                ++method.failures;
+                gate_passed = gate_passed && !method.gate;
+                std::cout << method.name << " FAILED on " << item.light_path << " / " << item.dark_path << std::endl;
+            }
+        }
+    }
+
+    std::cout << cases.size() << " pairs, tolerance " << tolerance << " px, " << repeat << " runs each\n"
+              << std::left << std::setw(20) << "method" << std::right << std::setw(10) << "ms/pair"
+              << std::setw(12) << "pupil mean" << std::setw(11) << "pupil max" << std::setw(11) << "pupil hit"
+              << std::setw(12) << "glint mean" << std::setw(11) << "glint max" << std::setw(11) << "glint hit"
+              << std::setw(10) << "failed" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const Method& method : methods) {
+        std::cout << std::left << std::setw(20) << (method.name + (method.gate ? "" : "*")) << std::right
+                  << std::setw(10) << (method.runs > 0 ? method.total_ms / method.runs : 0.0)
+                  << std::setw(12) << (method.pupil_count > 0 ? method.pupil_error_sum / method.pupil_count : 0.0)
+                  << std::setw(11) << method.pupil_error_max
+                  << std::setw(11) << (std::to_string(method.pupil_hits) + "/" + std::to_string(method.pupil_refs))
+                  << std::setw(12) << (method.glint_count > 0 ? method.glint_error_sum / method.glint_count : 0.0)
+                  << std::setw(11) << method.glint_error_max
+                  << std::setw(11) << (std::to_string(method.glint_hits) + "/" + std::to_string(method.glint_refs))
+                  << std::setw(10) << method.failures << "\n";
+    }
+    std::cout << "* not gated" << std::endl;
+    return gate_passed ? 0 : 1;
+}
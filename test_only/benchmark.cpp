@@ -0,0 +1,288 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/batch.h"
+#include "../src/detection.h"
+#include "../src/ellipse_fit.h"
+#include "../src/gradient_intersect.h"
+
+// 分阶段耗时基准：把 input/ 中的全部明暗图像对一次性读入内存（含编码后的文件字节），
+// 之后反复运行各阶段和 detect_pupil、光斑检测、GradientIntersect::locate，
+// 输出每个阶段的 p50/p95/p99 延迟和吞吐量。结果为 JSON，便于在版本之间比较。
+// 各分阶段按参考实现的顺序单独计时（差分、模糊、阈值分开调用），fused_mask 为融合实现。
+// 用法：benchmark [图像目录或清单] [迭代次数] [输出 JSON] [级联分类器路径]
+// 输出 JSON 省略时写到标准输出。
+
+/**
+ * @brief 一张图像：文件字节和解码结果。
+ */
+struct LoadedImage {
+    std::vector<uchar> bytes;
+    cv::Mat image;
+};
+
+/**
+ * @brief 一个阶段的全部耗时样本（毫秒），按注册顺序输出。
+ */
+struct Stage {
+    std::string name;
+    std::vector<double> samples;
+};
+
+static double elapsed_ms(int64_t start) {
+    return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+/**
+ * @brief 样本的 q 分位数（最近秩），samples 会被部分排序。
+ */
+static double percentile(std::vector<double>& samples, double q) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(q * samples.size());
+    rank = std::min(rank, samples.size() - 1);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+/**
+ * @brief 写出 JSON 字符串（路径中可能有引号和 Windows 反斜杠，需要转义）。
+ */
+static void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+static bool load_image(const std::string& path, LoadedImage& loaded) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    loaded.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    loaded.image = cv::imdecode(loaded.bytes, cv::IMREAD_COLOR);
+    return !loaded.image.empty();
+}
+
+/**
+ * @brief 轮廓中点数最多的一个，没有轮廓时返回 -1。
+ */
+static int largest_contour(const std::vector<std::vector<cv::Point>>& contours) {
+    int best = -1;
+    for (size_t i = 0; i < contours.size(); ++i) {
+        if (best < 0 || contours[i].size() > contours[best].size()) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    const std::string source = argc > 1 ? argv[1] : "input";
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+    const std::string output = argc > 3 ? argv[3] : "";
+    const std::string cascade = argc > 4 ? argv[4] : "haarcascades/haarcascade_eye.xml";
+
+    std::vector<BatchPair> pairs;
+    if (!list_batch_pairs(source, pairs)) {
+        return 1;
+    }
+    std::vector<std::pair<LoadedImage, LoadedImage>> corpus;
+    for (const BatchPair& pair : pairs) {
+        std::pair<LoadedImage, LoadedImage> loaded;
+        if (!load_image(pair.light_path, loaded.first) || !load_image(pair.dark_path, loaded.second) ||
+            loaded.first.image.size() != loaded.second.image.size()) {
+            std::cerr << "skipped " << pair.light_path << " / " << pair.dark_path << std::endl;
+            continue;
+        }
+        // 与 BatchRunner 相同的明暗判断，保证光斑检测等阶段运行在明瞳图像上
+        cv::Mat light = loaded.first.image, dark = loaded.second.image;
+        if (resolve_pair_order(pair, light, dark) == PAIR_ORDER_SWAPPED) {
+            std::swap(loaded.first, loaded.second);
+        }
+        corpus.push_back(std::move(loaded));
+    }
+    if (corpus.empty()) {
+        std::cerr << "no usable image pairs in " << source << std::endl;
+        return 1;
+    }
+
+    ReflectionDetector reflection(cascade);
+    if (!reflection.is_loaded()) {
+        return 1;
+    }
+    EllipseFitter fitter;
+    GradientIntersect gradient;
+
+    std::vector<Stage> stages;
+    auto stage = [&stages](const std::string& name) -> std::vector<double>& {
+        for (Stage& s : stages) {
+            if (s.name == name) {
+                return s.samples;
+            }
+        }
+        stages.push_back(Stage{name, std::vector<double>()});
+        return stages.back().samples;
+    };
+    // 先按输出顺序注册全部阶段，之后 stages 不再扩容，各阶段的引用保持有效
+    const char* names[] = {"decode", "diff", "blur", "threshold", "fused_mask", "contours", "ellipse_fit",
+                           "rank_candidates", "cascade", "moments", "detect_pupil", "detect_reflection",
+                           "gradient_locate"};
+    for (const char* name : names) {
+        stage(name).reserve(static_cast<size_t>(iterations) * corpus.size() * 2);
+    }
+    std::vector<double>& decode_ms = stage("decode");
+    std::vector<double>& diff_ms = stage("diff");
+    std::vector<double>& blur_ms = stage("blur");
+    std::vector<double>& threshold_ms = stage("threshold");
+    std::vector<double>& fused_mask_ms = stage("fused_mask");
+    std::vector<double>& contours_ms = stage("contours");
+    std::vector<double>& ellipse_fit_ms = stage("ellipse_fit");
+    std::vector<double>& rank_candidates_ms = stage("rank_candidates");
+    std::vector<double>& cascade_ms = stage("cascade");
+    std::vector<double>& moments_ms = stage("moments");
+    std::vector<double>& detect_pupil_ms = stage("detect_pupil");
+    std::vector<double>& detect_reflection_ms = stage("detect_reflection");
+    std::vector<double>& gradient_locate_ms = stage("gradient_locate");
+
+    cv::Mat decoded, diff, gray, blurred, binary, fused, gray_light, glint_blurred, glint_binary;
+    std::vector<std::vector<cv::Point>> contours, glint_contours;
+    EllipseFit fit;
+    PupilCandidates ranked;
+    int64_t start = 0;
+    const int64_t total_start = cv::getTickCount();
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (const auto& pair : corpus) {
+            const cv::Mat& light = pair.first.image;
+            const cv::Mat& dark = pair.second.image;
+
+            for (const LoadedImage* loaded : {&pair.first, &pair.second}) {
+                start = cv::getTickCount();
+                decoded = cv::imdecode(loaded->bytes, cv::IMREAD_COLOR);
+                decode_ms.push_back(elapsed_ms(start));
+            }
+
+            // 参考实现的各个阶段
+            start = cv::getTickCount();
+            cv::absdiff(light, dark, diff);
+            cv::cvtColor(diff, gray, cv::COLOR_BGR2GRAY);
+            diff_ms.push_back(elapsed_ms(start));
+
+            start = cv::getTickCount();
+            cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
+            blur_ms.push_back(elapsed_ms(start));
+
+            start = cv::getTickCount();
+            cv::threshold(blurred, binary, 50, 255, cv::THRESH_BINARY);
+            threshold_ms.push_back(elapsed_ms(start));
+
+            start = cv::getTickCount();
+            compute_pupil_mask(light, dark, fused);
+            fused_mask_ms.push_back(elapsed_ms(start));
+
+            start = cv::getTickCount();
+            cv::findContours(fused, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+            contours_ms.push_back(elapsed_ms(start));
+
+            const int largest = largest_contour(contours);
+            if (largest >= 0) {
+                fitter.begin_frame();
+                start = cv::getTickCount();
+                fitter.fit(contours[largest], fit);
+                ellipse_fit_ms.push_back(elapsed_ms(start));
+            }
+
+            start = cv::getTickCount();
+            rank_pupil_candidates(light, dark, fused, fitter, cv::Point2f(-1.f, -1.f), ranked);
+            rank_candidates_ms.push_back(elapsed_ms(start));
+
+            // 光斑检测的各个阶段
+            cv::cvtColor(light, gray_light, cv::COLOR_BGR2GRAY);
+            start = cv::getTickCount();
+            const std::vector<cv::Rect>& eyes = reflection.detect_eyes(gray_light);
+            cascade_ms.push_back(elapsed_ms(start));
+            const cv::Rect eye = eyes.empty() ? cv::Rect(0, 0, light.cols, light.rows) : eyes[0];
+
+            start = cv::getTickCount();
+            cv::GaussianBlur(gray_light(eye), glint_blurred, cv::Size(3, 3), 0);
+            cv::threshold(glint_blurred, glint_binary, 230, 255, cv::THRESH_BINARY);
+            cv::findContours(glint_binary, glint_contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+            for (const auto& contour : glint_contours) {
+                volatile double m00 = cv::moments(contour).m00;
+                (void)m00;
+            }
+            moments_ms.push_back(elapsed_ms(start));
+
+            // 端到端
+            start = cv::getTickCount();
+            PupilResult pupil = detect_pupil(light, dark);
+            detect_pupil_ms.push_back(elapsed_ms(start));
+
+            start = cv::getTickCount();
+            reflection.process(light);
+            detect_reflection_ms.push_back(elapsed_ms(start));
+
+            // 在瞳孔附近（未找到时在眼睛区域）的裁剪图上定位，与实际使用方式一致
+            cv::Rect crop = eye;
+            if (pupil.found) {
+                const int half = 60;
+                crop = cv::Rect(cv::Point(cvRound(pupil.center.x) - half, cvRound(pupil.center.y) - half),
+                                cv::Size(2 * half, 2 * half)) & cv::Rect(0, 0, light.cols, light.rows);
+            }
+            start = cv::getTickCount();
+            gradient.locate(gray_light(crop));
+            gradient_locate_ms.push_back(elapsed_ms(start));
+        }
+    }
+    const double total_sec = elapsed_ms(total_start) / 1000.0;
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            std::cerr << "could not open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    out << "{\n"
+        << "  \"source\": ";
+    write_json_string(out, source);
+    out << ",\n"
+        << "  \"pairs\": " << corpus.size() << ",\n"
+        << "  \"iterations\": " << iterations << ",\n"
+        << "  \"opencv_version\": \"" << CV_VERSION << "\",\n"
+        << "  \"opencv_threads\": " << cv::getNumThreads() << ",\n"
+        << "  \"total_sec\": " << total_sec << ",\n"
+        << "  \"stages\": {\n";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        std::vector<double>& samples = stages[i].samples;
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        const double mean = samples.empty() ? 0.0 : sum / samples.size();
+        out << "    \"" << stages[i].name << "\": {"
+            << "\"samples\": " << samples.size()
+            << ", \"mean_ms\": " << mean
+            << ", \"p50_ms\": " << percentile(samples, 0.50)
+            << ", \"p95_ms\": " << percentile(samples, 0.95)
+            << ", \"p99_ms\": " << percentile(samples, 0.99)
+            << ", \"per_second\": " << (mean > 0 ? 1000.0 / mean : 0.0) << "}"
+            << (i + 1 < stages.size() ? "," : "") << "\n";
+    }
+    out << "  }\n}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "../src/binocular.h"
+#include "../src/synthetic_eye.h"
+
+// 比较 BinocularDetector 在已知眼睛区域路径上处理一只眼睛和两只眼睛的延迟：
+// 把两对不同种子的合成图像左右拼接成双眼帧，分别只传左眼区域和传两个区域，
+// 两只眼睛的瞳孔都必须检测到。双眼在两个线程上并行，多核机器上双眼延迟
+// 不应超过单眼的 MAX_TWO_EYE_RATIO 倍（单核机器上只报告，不检查）。
+// 用法：binocular_check [帧数]
+
+// 双眼与单眼平均延迟之比的上限
+static const double MAX_TWO_EYE_RATIO = 1.5;
+
+// 检测到的瞳孔中心与真值的最大允许偏差（像素）
+static const double MAX_CENTER_ERROR = 2.0;
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+
+    // 两只眼睛的合成图像左右拼接，第二只眼睛的坐标整体右移一个图像宽度
+    SyntheticEyeParams params = synthetic_eye_params(cv::Size(640, 480));
+    params.center_jitter = 20.f;
+    SyntheticEyeGenerator left_eye(params);
+    params.seed = 2;
+    SyntheticEyeGenerator right_eye(params);
+    cv::Mat lights[2], darks[2], light, dark;
+    SyntheticEyeTruth truths[2];
+    left_eye.generate(lights[0], darks[0], truths[0]);
+    right_eye.generate(lights[1], darks[1], truths[1]);
+    cv::hconcat(lights[0], lights[1], light);
+    cv::hconcat(darks[0], darks[1], dark);
+    const cv::Point2f shift(static_cast<float>(params.size.width), 0.f);
+    const cv::Rect rois[2] = {truths[0].eye_roi, truths[1].eye_roi + cv::Point(params.size.width, 0)};
+    const cv::Point2f centers[2] = {truths[0].pupil.center, truths[1].pupil.center + shift};
+
+    BinocularDetector detector;
+    double ms[2] = {0.0, 0.0};
+    bool found = true;
+    for (int eyes = 1; eyes <= 2; ++eyes) {
+        // 预热：工作线程启动、缓冲区按眼睛区域扩容
+        detector.process(light, dark, rois, eyes);
+        const int64_t start = cv::getTickCount();
+        BinocularResult result;
+        for (int i = 0; i < frames; ++i) {
+            result = detector.process(light, dark, rois, eyes);
+        }
+        ms[eyes - 1] = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency() / frames;
+
+        for (int i = 0; i < eyes; ++i) {
+            const EyeObservation& eye = result.eyes[i];
+            const cv::Point2f delta = eye.pupil.center - centers[i];
+            const bool ok = result.eye_count == eyes && eye.pupil.found &&
+                            delta.x * delta.x + delta.y * delta.y <= MAX_CENTER_ERROR * MAX_CENTER_ERROR;
+            found = found && ok;
+            std::cout << eyes << " eye(s), eye " << i << ": pupil (" << eye.pupil.center.x << ", "
+                      << eye.pupil.center.y << ") truth (" << centers[i].x << ", " << centers[i].y << ")"
+                      << (ok ? "" : "  FAILED") << std::endl;
+        }
+    }
+
+    const double ratio = ms[1] / ms[0];
+    const bool parallel = std::thread::hardware_concurrency() > 1;
+    const bool fast_enough = !parallel || ratio <= MAX_TWO_EYE_RATIO;
+    std::cout << frames << " frames: one eye " << ms[0] << " ms, two eyes " << ms[1] << " ms, ratio " << ratio
+              << (parallel ? "" : " (single core, not checked)") << (fast_enough ? "" : "  FAILED") << std::endl;
+    return found && fast_enough ? 0 : 1;
+}
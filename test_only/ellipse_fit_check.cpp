@@ -0,0 +1,92 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "../src/ellipse_fit.h"
+
+// 在合成的椭圆轮廓上对比 cv::fitEllipse、EllipseFitter 直接拟合和 RANSAC 的中心误差与耗时。
+// 一半样本的下半段轮廓被一条“眼睑”横线替换，模拟遮挡。
+// 用法：ellipse_fit_check [样本数]
+int main(int argc, char** argv) {
+    const int samples = argc > 1 ? std::max(1, std::atoi(argv[1])) : 500;
+    cv::RNG rng(12345);
+
+    EllipseFitParams direct_params;
+    direct_params.mode = ELLIPSE_FIT_DIRECT;
+    EllipseFitter direct(direct_params);
+    EllipseFitter ransac;
+
+    double error_sum[2][3] = {}, error_max[2][3] = {}, time_ms[3] = {};
+    int counted[2] = {}, failures = 0;
+    for (int s = 0; s < samples; ++s) {
+        const bool occluded = s % 2 == 1;
+        const cv::Point2f center(rng.uniform(50.f, 150.f), rng.uniform(50.f, 150.f));
+        const float semi_major = rng.uniform(10.f, 30.f);
+        const float semi_minor = semi_major * rng.uniform(0.6f, 1.0f);
+        const double theta = rng.uniform(0.0, CV_PI);
+        const int n = rng.uniform(40, 240);
+
+        std::vector<cv::Point2f> points;
+        for (int i = 0; i < n; ++i) {
+            const double phi = 2 * CV_PI * i / n;
+            const double x = semi_major * std::cos(phi), y = semi_minor * std::sin(phi);
+            if (occluded && phi > 1.2 * CV_PI) {
+                // 被遮挡的部分换成一条水平线上的点
+                if (i % 2 == 0) {
+                    points.emplace_back(center.x + rng.uniform(-semi_major, semi_major), center.y + 0.2f * semi_minor);
+                }
+                continue;
+            }
+            points.emplace_back(static_cast<float>(center.x + x * std::cos(theta) - y * std::sin(theta) + rng.gaussian(0.3)),
+                                static_cast<float>(center.y + x * std::sin(theta) + y * std::cos(theta) + rng.gaussian(0.3)));
+        }
+
+        cv::RotatedRect fitted[3];
+        bool ok[3] = {true, false, false};
+        EllipseFit fit;
+        int64_t start = cv::getTickCount();
+        fitted[0] = cv::fitEllipse(points);
+        time_ms[0] += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        start = cv::getTickCount();
+        ok[1] = direct.fit(points, fit);
+        fitted[1] = fit.ellipse;
+        time_ms[1] += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        ransac.begin_frame();
+        start = cv::getTickCount();
+        ok[2] = ransac.fit(points, fit);
+        fitted[2] = fit.ellipse;
+        time_ms[2] += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        if (!ok[1] || !ok[2]) {
+            ++failures;
+            continue;
+        }
+        ++counted[occluded];
+        for (int k = 0; k < 3; ++k) {
+            const cv::Point2f delta = fitted[k].center - center;
+            const double error = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+            error_sum[occluded][k] += error;
+            error_max[occluded][k] = std::max(error_max[occluded][k], error);
+        }
+    }
+
+    const char* names[3] = {"cv::fitEllipse", "direct", "ransac"};
+    for (int occluded = 0; occluded < 2; ++occluded) {
+        std::cout << (occluded ? "occluded" : "complete") << " contours (" << counted[occluded] << "):" << std::endl;
+        for (int k = 0; k < 3; ++k) {
+            std::cout << "  " << names[k] << ": mean center error " << error_sum[occluded][k] / std::max(1, counted[occluded])
+                      << " px, max " << error_max[occluded][k] << " px" << std::endl;
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        std::cout << names[k] << ": " << time_ms[k] * 1000.0 / samples << " us per contour" << std::endl;
+    }
+    std::cout << failures << " failed fits" << std::endl;
+
+    // RANSAC 在遮挡样本上应明显优于对全部点拟合
+    const bool better = error_sum[1][2] < error_sum[1][1];
+    return (failures == 0 && better) ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "../src/detection.h"
+#include "../src/eye_tracker.h"
+#include "../src/frame_pair.h"
+#include "../src/synthetic_eye.h"
+#include "../src/video_source.h"
+
+// 在明暗交替视频上对比 EyeTracker 与逐帧整帧检测（detect_pupil + ReflectionDetector）：
+// 输出每对的平均耗时、整帧搜索的次数，以及两者都检测到瞳孔时的中心偏差。
+// 不给视频时改为在瞳孔匀速移动的合成序列上检查：只有第一对做整帧搜索，
+// 之后的搜索区域不超过整帧的 MAX_ROI_FRACTION，且跟踪到的中心与真值相差不超过 MAX_CENTER_ERROR。
+// 用法：eye_tracker_check [视频路径 [级联分类器路径]]
+
+// 合成序列的对数和瞳孔每对的位移（像素）
+static const int SYNTHETIC_PAIRS = 60;
+static const cv::Point2f SYNTHETIC_VELOCITY(3.f, -1.5f);
+
+// 跟踪状态下搜索区域面积占整帧的上限
+static const double MAX_ROI_FRACTION = 0.1;
+
+// 跟踪到的瞳孔中心与真值的最大允许偏差（像素）
+static const double MAX_CENTER_ERROR = 2.0;
+
+/**
+ * @brief 在合成序列上检查 EyeTracker 是否在第一对之后一直停留在跟踪状态。
+ * @return 检查通过返回 0。
+ */
+static int check_synthetic(const std::string& cascade) {
+    SyntheticEyeParams params = synthetic_eye_params(cv::Size(640, 480));
+    // 两次曝光之间瞳孔也在移动，跟踪状态下由帧配准补偿
+    params.motion = SYNTHETIC_VELOCITY * 0.5f;
+    const cv::Point2f start(220.f, 260.f);
+    const double frame_area = static_cast<double>(params.size.area());
+
+    EyeTracker tracker(EyeTrackerParams(), cascade);
+    SyntheticEyeGenerator generator;
+    cv::Mat light, dark;
+    SyntheticEyeTruth truth;
+    int failed = 0;
+    double max_roi_fraction = 0.0, max_error = 0.0, min_confidence = 1.0;
+    for (int i = 0; i < SYNTHETIC_PAIRS; ++i) {
+        params.pupil_center = start + SYNTHETIC_VELOCITY * static_cast<float>(i);
+        params.seed = static_cast<uint64_t>(i + 1);
+        generator.set_params(params);
+        generator.generate(light, dark, truth);
+
+        const EyeTrackResult tracked = tracker.process(light, dark);
+        const double roi_fraction = tracked.search_roi.area() / frame_area;
+        const cv::Point2f delta = tracked.pupil.center - truth.pupil.center;
+        const double error = tracked.pupil.found ? std::sqrt(delta.x * delta.x + delta.y * delta.y) : -1.0;
+        const bool passed = tracked.full_frame == (i == 0) && (i == 0 || roi_fraction <= MAX_ROI_FRACTION) &&
+                            tracked.pupil.found && error <= MAX_CENTER_ERROR;
+        if (!passed) {
+            ++failed;
+        }
+        if (i > 0) {
+            max_roi_fraction = std::max(max_roi_fraction, roi_fraction);
+        }
+        max_error = std::max(max_error, error);
+        min_confidence = std::min(min_confidence, static_cast<double>(tracked.pupil.confidence));
+        std::cout << "pair " << i << (tracked.full_frame ? " full frame" : " roi ") << tracked.search_roi
+                  << " confidence " << tracked.pupil.confidence << " error " << error << " px"
+                  << (passed ? "" : "  FAILED") << std::endl;
+    }
+    std::cout << SYNTHETIC_PAIRS << " synthetic pairs, " << failed << " failed; max search area "
+              << 100.0 * max_roi_fraction << "% of the frame, max center error " << max_error
+              << " px, min confidence " << min_confidence << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const std::string cascade = argc > 2 ? argv[2] : "haarcascades/haarcascade_eye.xml";
+    if (argc < 2) {
+        return check_synthetic(cascade);
+    }
+
+    VideoFrameSource source;
+    if (!source.open(argv[1])) {
+        return 1;
+    }
+    FramePairDemuxer demuxer;
+    EyeTracker tracker(EyeTrackerParams(), cascade);
+    ReflectionDetector reflection_detector(cascade);
+    if (!reflection_detector.is_loaded()) {
+        return 1;
+    }
+
+    FramePair pair;
+    double timestamp = 0.0;
+    int pairs = 0, full_frame_searches = 0, both_found = 0, tracker_found = 0, reference_found = 0;
+    double tracker_ms = 0.0, reference_ms = 0.0, deviation_sum = 0.0, deviation_max = 0.0;
+    double roi_area = 0.0;
+    while (source.read_into(demuxer.next_buffer(), &timestamp)) {
+        if (!demuxer.commit(timestamp, pair)) {
+            continue;
+        }
+        ++pairs;
+
+        int64_t start = cv::getTickCount();
+        const EyeTrackResult tracked = tracker.process(pair.light, pair.dark);
+        tracker_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        start = cv::getTickCount();
+        const PupilResult reference = detect_pupil(pair.light, pair.dark);
+        reflection_detector.process(pair.light);
+        reference_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        full_frame_searches += tracked.full_frame ? 1 : 0;
+        roi_area += tracked.search_roi.area();
+        tracker_found += tracked.pupil.found ? 1 : 0;
+        reference_found += reference.found ? 1 : 0;
+        if (tracked.pupil.found && reference.found) {
+            ++both_found;
+            const cv::Point2f delta = tracked.pupil.center - reference.center;
+            const double deviation = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+            deviation_sum += deviation;
+            deviation_max = std::max(deviation_max, deviation);
+        }
+    }
+    if (pairs == 0) {
+        std::cout << "no frame pairs" << std::endl;
+        return 1;
+    }
+
+    const double frame_area = static_cast<double>(source.width()) * source.height();
+    std::cout << pairs << " pairs, " << full_frame_searches << " full-frame searches" << std::endl;
+    std::cout << "mean search area: " << 100.0 * roi_area / pairs / frame_area << "% of the frame" << std::endl;
+    std::cout << "tracker:    " << tracker_ms / pairs << " ms/pair, pupil found in " << tracker_found << std::endl;
+    std::cout << "full frame: " << reference_ms / pairs << " ms/pair, pupil found in " << reference_found << std::endl;
+    if (both_found > 0) {
+        std::cout << "center deviation: mean " << deviation_sum / both_found << " px, max " << deviation_max << " px"
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/detection.h"
+#include "../src/fixed_point_pupil.h"
+
+// 对比 FixedPointPupilModel 与 OpenCV 浮点路径（compute_pupil_mask + locate_pupil_in_mask）：
+// 二值图像应逐像素一致；中心和轴长的偏差来自矩等效椭圆与轮廓拟合椭圆的差异。
+// 尺寸不一致或浮点路径无法生成二值图像的图像对记为失败，不参与比较。
+// 用法：fixed_point_check [明瞳 暗瞳]...，缺省使用 input/ 下的明暗瞳图像对。
+int main(int argc, char** argv) {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        pairs.emplace_back(argv[i], argv[i + 1]);
+    }
+    if (pairs.empty()) {
+        pairs = {
+            {"input/2.bmp", "input/1.bmp"},
+            {"input/3.bmp", "input/4.bmp"},
+            {"input/5.bmp", "input/6.bmp"},
+            {"input/5(expose).bmp", "input/6(expose).bmp"},
+        };
+    }
+
+    FixedPointPupilModel model;
+    int compared = 0, mask_mismatched = 0, failed = 0;
+    double max_center_error = 0.0;
+    for (const auto& pair : pairs) {
+        cv::Mat light = cv::imread(pair.first);
+        cv::Mat dark = cv::imread(pair.second);
+        if (light.empty() || dark.empty()) {
+            std::cout << pair.first << " / " << pair.second << ": skipped (unreadable)" << std::endl;
+            continue;
+        }
+        if (light.size() != dark.size()) {
+            std::cout << pair.first << " / " << pair.second << ": FAILED (size mismatch " << light.cols << "x"
+                      << light.rows << " vs " << dark.cols << "x" << dark.rows << ")" << std::endl;
+            ++failed;
+            continue;
+        }
+
+        int64_t start = cv::getTickCount();
+        cv::Mat float_mask;
+        if (!compute_pupil_mask(light, dark, float_mask)) {
+            std::cout << pair.first << " / " << pair.second << ": FAILED (compute_pupil_mask)" << std::endl;
+            ++failed;
+            continue;
+        }
+        ++compared;
+        PupilResult reference = locate_pupil_in_mask(float_mask);
+        double float_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        start = cv::getTickCount();
+        cv::Mat fixed_mask;
+        FixedPupilResult fixed = model.process(light, dark, &fixed_mask);
+        double fixed_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        cv::Mat mask_diff;
+        cv::compare(float_mask, fixed_mask, mask_diff, cv::CMP_NE);
+        const int differing_pixels = cv::countNonZero(mask_diff);
+        if (differing_pixels > 0) {
+            ++mask_mismatched;
+        }
+
+        std::cout << pair.first << " / " << pair.second << std::endl;
+        std::cout << "  mask: " << differing_pixels << " differing pixels" << std::endl;
+        std::cout << "  float: found=" << reference.found;
+        if (reference.found) {
+            std::cout << " center=(" << reference.center.x << ", " << reference.center.y << ")"
+                      << " axes=" << std::max(reference.ellipse.size.width, reference.ellipse.size.height)
+                      << "/" << std::min(reference.ellipse.size.width, reference.ellipse.size.height);
+        }
+        std::cout << " " << float_ms << "ms" << std::endl;
+        std::cout << "  fixed: found=" << fixed.found;
+        if (fixed.found) {
+            std::cout << " center=(" << fixed.center().x << ", " << fixed.center().y << ")"
+                      << " axes=" << fixed.major_q8 / 256.0 << "/" << fixed.minor_q8 / 256.0
+                      << " area=" << fixed.area;
+        }
+        std::cout << " components=" << fixed.components << (fixed.label_overflow ? " (label overflow)" : "")
+                  << " " << fixed_ms << "ms" << std::endl;
+        if (reference.found && fixed.found) {
+            const cv::Point2f delta = fixed.center() - reference.center;
+            const double error = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+            max_center_error = std::max(max_center_error, error);
+            std::cout << "  center deviation: " << error << " px" << std::endl;
+        } else if (reference.found != fixed.found) {
+            std::cout << "  detection differs" << std::endl;
+        }
+    }
+
+    std::cout << compared << " pairs, " << mask_mismatched << " with differing masks, " << failed
+              << " failed, max center deviation " << max_center_error << " px" << std::endl;
+    return (compared > 0 && mask_mismatched == 0 && failed == 0) ? 0 : 1;
+}
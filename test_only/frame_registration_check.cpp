@@ -0,0 +1,84 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../src/detection.h"
+#include "../src/frame_registration.h"
+#include "../src/synthetic_eye.h"
+
+// 用已知眼动（SyntheticEyeParams::motion）的合成图像对检查 FrameRegistration：
+// 恢复的平移与 motion 的偏差不超过 MAX_SHIFT_ERROR（同时验证了符号约定），
+// 对齐后眼睛区域内二值差分图像的像素数（瞳孔本身 + 月牙形残差）不多于对齐前，
+// 且不超过同一位置无眼动时的 MAX_RESIDUAL_RATIO 倍（验证了 WARP_INVERSE_MAP 的组合方向）。
+// 用法：frame_registration_check [每种眼动的图像对数]
+
+// 平移估计的最大允许误差（像素）
+static const double MAX_SHIFT_ERROR = 0.5;
+
+// 对齐后残差相对无眼动基线的上限
+static const double MAX_RESIDUAL_RATIO = 1.05;
+
+/**
+ * @brief light 与 dark 差分后二值图像中的前景像素数。
+ */
+static int mask_pixels(const cv::Mat& light, const cv::Mat& dark) {
+    cv::Mat mask;
+    if (!compute_pupil_mask(light, dark, mask)) {
+        return -1;
+    }
+    return cv::countNonZero(mask);
+}
+
+int main(int argc, char** argv) {
+    const int pairs_per_motion = argc > 1 ? std::max(1, std::atoi(argv[1])) : 8;
+    const std::vector<cv::Point2f> motions = {
+        {0.f, 0.f}, {3.f, 0.f}, {0.f, -3.f}, {2.5f, 1.75f}, {-4.5f, 1.5f}, {-1.25f, -5.5f}, {6.f, -4.f},
+    };
+
+    FrameRegistration registration;
+    int checked = 0, failed = 0;
+    double max_error = 0.0, max_ratio = 0.0;
+    for (const cv::Point2f& motion : motions) {
+        // 相同种子的有眼动和无眼动生成器产生相同的瞳孔位置和噪声
+        SyntheticEyeParams params = synthetic_eye_params(cv::Size(640, 480));
+        params.center_jitter = 40.f;
+        SyntheticEyeGenerator still(params);
+        params.motion = motion;
+        SyntheticEyeGenerator moving(params);
+
+        cv::Mat light, dark, still_light, still_dark, aligned;
+        SyntheticEyeTruth truth, still_truth;
+        for (int i = 0; i < pairs_per_motion; ++i) {
+            moving.generate(light, dark, truth);
+            still.generate(still_light, still_dark, still_truth);
+            const cv::Rect& roi = truth.eye_roi;
+
+            cv::Point2d shift;
+            const bool ok = registration.align(light, dark, roi, aligned, &shift);
+            const double error = std::hypot(shift.x - motion.x, shift.y - motion.y);
+            const int baseline = mask_pixels(still_light(roi), still_dark(roi));
+            const int unaligned = mask_pixels(light(roi), dark(roi));
+            const int residual = mask_pixels(light(roi), aligned);
+            const double ratio = baseline > 0 ? static_cast<double>(residual) / baseline : 0.0;
+
+            const bool passed = ok && error <= MAX_SHIFT_ERROR && baseline > 0 && residual <= unaligned &&
+                                ratio <= MAX_RESIDUAL_RATIO;
+            ++checked;
+            if (!passed) {
+                ++failed;
+            }
+            max_error = std::max(max_error, error);
+            max_ratio = std::max(max_ratio, ratio);
+            std::cout << "motion=(" << motion.x << ", " << motion.y << ") shift=(" << shift.x << ", " << shift.y
+                      << ") response=" << registration.last_response() << " mask pixels: still=" << baseline
+                      << " unaligned=" << unaligned << " aligned=" << residual << (passed ? "" : "  FAILED")
+                      << std::endl;
+        }
+    }
+
+    std::cout << checked << " pairs, " << failed << " failed, max shift error " << max_error
+              << " px, max residual ratio " << max_ratio << std::endl;
+    return (checked > 0 && failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/gradient_intersect.h"
+
+// 旧版 OpenMP 实现（preversion/grad.cpp）放进独立的命名空间，与 src/ 的同名类区分；
+// 它依赖的标准头已在上面包含，文件内的 main 改名后不参与链接
+namespace preversion {
+#define main grad_main
+#include "../preversion/grad.cpp"
+#undef main
+}
+
+// 检查 GradientIntersect 各种得分计算方式的一致性：
+// 1. 直接累加与 FFT：对 input/ 下的每张图像分别用两种方式定位，中心必须一致；两者的浮点舍入不同，
+//    得分几乎相等的并列极大值可能落在不同位置，此时只要求各自的中心在对方得分图上
+//    与最高分的相对差不超过 SCORE_TOLERANCE（记为 near-tie）。
+//    默认 15 像素窗口对所有图像都比较；整 ROI 统计只对小图（眼部裁剪图）比较，
+//    大图上直接累加的整 ROI 版本太慢。
+// 2. 与旧版 OpenMP 实现（preversion/grad.cpp）比较：把小图缩放为 LEGACY_ROI_SIDE 见方的眼睛区域，
+//    两者使用相同参数（15 像素窗口、sigma 2），报告中心和耗时之比。旧版只有在编译时启用 OpenMP
+//    （MSVC /openmp、GCC -fopenmp）才是并行的，输出中会注明。
+// 3. 稀疏与稠密：在每张小图上分别用 sparse=true/false 定位，报告入选像素的比例（即计算量的缩减）。
+//    稀疏模式不统计弱梯度，得分函数本身不同，因此只要求两者中心一致，或稀疏中心在稠密得分图上
+//    与最高分的相对差不超过 SPARSE_SCORE_TOLERANCE（记为 near-tie）。
+// 4. 由粗到精与穷举：在每张小图上比较 locateRefined 与 locate，两者的中心相差不能超过
+//    REFINED_MAX_DISTANCE；再在第一张大图中央截取不同边长的方形区域，报告两者的耗时随 ROI 尺寸的变化。
+// 大图（整帧）上两种近似方式与穷举的极大值经常落在互不相关的暗区，只比较眼部裁剪图。
+
+// 并列极大值的相对得分容差
+static const float SCORE_TOLERANCE = 1e-4f;
+
+// 整 ROI 统计和旧版比较只用最大边不超过该值的图像（眼部裁剪图）
+static const int SMALL_IMAGE_MAX_SIDE = 200;
+
+// 与旧版比较时的眼睛区域边长
+static const int LEGACY_ROI_SIDE = 60;
+
+// 稀疏中心在稠密得分图上允许的相对得分差
+static const float SPARSE_SCORE_TOLERANCE = 0.06f;
+
+// locateRefined 与穷举 locate 的中心之间允许的最大距离（像素）
+static const double REFINED_MAX_DISTANCE = 1.0;
+
+// 计时所用的方形 ROI 边长
+static const int TIMING_ROI_SIDES[] = {64, 128, 256, 512};
+
+// 计时重复次数，取平均
+static const int TIMING_RUNS = 20;
+
+/**
+ * @brief location 处的得分是否与得分图最高分相差不超过 tolerance（相对值）。
+ */
+static bool near_maximum(const cv::Mat& scores, const cv::Point& location, float tolerance = SCORE_TOLERANCE) {
+    double max_score = 0;
+    cv::minMaxLoc(scores, nullptr, &max_score);
+    return scores.at<float>(location) >= max_score - tolerance * std::abs(max_score);
+}
+
+/**
+ * @brief 重复调用 locate 计时，返回平均每次的毫秒数。
+ */
+template <typename Locate>
+static double average_ms(Locate locate) {
+    const int64_t start = cv::getTickCount();
+    for (int i = 0; i < TIMING_RUNS; ++i) {
+        locate();
+    }
+    return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency() / TIMING_RUNS;
+}
+
+/**
+ * @brief 比较直接累加与 FFT 两种方式的定位结果。
+ * @return 不一致的比较次数。
+ */
+static int compare_engines(const std::string& file, const cv::Mat& image, int& compared) {
+    static GradientIntersect direct, fft;
+    std::vector<int> windows = {15};
+    if (std::max(image.rows, image.cols) <= SMALL_IMAGE_MAX_SIDE) {
+        windows.push_back(0);
+    }
+    int mismatched = 0;
+    for (int window : windows) {
+        GradientIntersectParams params;
+        params.window = window;
+        params.engine = GRADIENT_ENGINE_DIRECT;
+        int64_t start = cv::getTickCount();
+        cv::Point p_direct = direct.locate(image, params);
+        double direct_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        const cv::Mat direct_scores = direct.scores().clone();
+
+        params.engine = GRADIENT_ENGINE_FFT;
+        start = cv::getTickCount();
+        cv::Point p_fft = fft.locate(image, params);
+        double fft_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        const bool exact = p_direct == p_fft;
+        const bool match = exact || (p_direct.x >= 0 && p_fft.x >= 0 && near_maximum(direct_scores, p_fft) &&
+                                     near_maximum(fft.scores(), p_direct));
+        ++compared;
+        if (!match) {
+            ++mismatched;
+        }
+        std::cout << file << " window=" << (window > 0 ? std::to_string(window) : "full")
+                  << " direct=(" << p_direct.x << ", " << p_direct.y << ") " << direct_ms << "ms"
+                  << " fft=(" << p_fft.x << ", " << p_fft.y << ") " << fft_ms << "ms"
+                  << (exact ? "" : match ? "  near-tie" : "  MISMATCH") << std::endl;
+    }
+    return mismatched;
+}
+
+/**
+ * @brief 在 LEGACY_ROI_SIDE 见方的眼睛区域上比较旧版 OpenMP 实现与当前实现的耗时。
+ * @return 当前实现相对旧版的加速比。
+ */
+static double compare_legacy(const std::string& file, const cv::Mat& image) {
+    static GradientIntersect current;
+    static preversion::GradientIntersect legacy;
+    cv::Mat roi;
+    cv::resize(image, roi, cv::Size(LEGACY_ROI_SIDE, LEGACY_ROI_SIDE), 0, 0, cv::INTER_AREA);
+
+    cv::Point p_current, p_legacy;
+    const double current_ms = average_ms([&] { p_current = current.locate(roi); });
+    const double legacy_ms = average_ms([&] { p_legacy = legacy.locate(roi); });
+    const double speedup = current_ms > 0 ? legacy_ms / current_ms : 0.0;
+    std::cout << file << " " << LEGACY_ROI_SIDE << "x" << LEGACY_ROI_SIDE << " current=(" << p_current.x << ", "
+              << p_current.y << ") " << current_ms << "ms legacy=(" << p_legacy.x << ", " << p_legacy.y << ") "
+              << legacy_ms << "ms speedup " << speedup << "x" << std::endl;
+    return speedup;
+}
+
+/**
+ * @brief 比较稀疏与稠密模式的定位结果，并统计入选像素的比例。
+ * @param kept_ratio 输出稀疏模式入选像素占全部像素的比例。
+ * @return 两者是否一致（中心相同或近似并列）。
+ */
+static bool compare_sparse(const std::string& file, const cv::Mat& image, double& kept_ratio) {
+    static GradientIntersect dense, sparse;
+    GradientIntersectParams params;
+    cv::Point p_dense, p_sparse;
+    const double dense_ms = average_ms([&] { p_dense = dense.locate(image, params); });
+    params.sparse = true;
+    const double sparse_ms = average_ms([&] { p_sparse = sparse.locate(image, params); });
+    kept_ratio = static_cast<double>(sparse.sparsePointCount()) / image.total();
+
+    const bool exact = p_dense == p_sparse;
+    const bool match = exact || (p_sparse.x >= 0 && near_maximum(dense.scores(), p_sparse, SPARSE_SCORE_TOLERANCE));
+    std::cout << file << " dense=(" << p_dense.x << ", " << p_dense.y << ") " << dense_ms << "ms sparse=("
+              << p_sparse.x << ", " << p_sparse.y << ") " << sparse_ms << "ms kept " << kept_ratio * 100 << "%"
+              << (exact ? "" : match ? "  near-tie" : "  MISMATCH") << std::endl;
+    return match;
+}
+
+/**
+ * @brief 比较 locateRefined 与穷举 locate 的中心。
+ * @return 两者相差是否不超过 REFINED_MAX_DISTANCE。
+ */
+static bool compare_refined(const std::string& file, const cv::Mat& image) {
+    static GradientIntersect exhaustive, refined;
+    cv::Point p_exhaustive;
+    cv::Point2f p_refined;
+    const double exhaustive_ms = average_ms([&] { p_exhaustive = exhaustive.locate(image); });
+    const double refined_ms = average_ms([&] { p_refined = refined.locateRefined(image); });
+    const double distance = std::hypot(p_refined.x - p_exhaustive.x, p_refined.y - p_exhaustive.y);
+    const bool match = p_exhaustive.x >= 0 && p_refined.x >= 0 && distance <= REFINED_MAX_DISTANCE;
+    std::cout << file << " exhaustive=(" << p_exhaustive.x << ", " << p_exhaustive.y << ") " << exhaustive_ms
+              << "ms refined=(" << p_refined.x << ", " << p_refined.y << ") " << refined_ms << "ms distance "
+              << distance << (match ? "" : "  MISMATCH") << std::endl;
+    return match;
+}
+
+/**
+ * @brief 在 image 中央截取 TIMING_ROI_SIDES 各边长的方形区域，报告 locate 与 locateRefined 的耗时。
+ */
+static void time_refined(const std::string& file, const cv::Mat& image) {
+    GradientIntersect exhaustive, refined;
+    std::cout << "timing on " << file << " (ms per call, relative to the smallest ROI)" << std::endl;
+    double first_exhaustive = 0, first_refined = 0;
+    for (int side : TIMING_ROI_SIDES) {
+        if (side > image.cols || side > image.rows) {
+            break;
+        }
+        const cv::Mat roi = image(cv::Rect((image.cols - side) / 2, (image.rows - side) / 2, side, side));
+        const double exhaustive_ms = average_ms([&] { exhaustive.locate(roi); });
+        const double refined_ms = average_ms([&] { refined.locateRefined(roi); });
+        if (first_exhaustive == 0) {
+            first_exhaustive = exhaustive_ms;
+            first_refined = refined_ms;
+        }
+        std::cout << "  " << side << "x" << side << " exhaustive " << exhaustive_ms << "ms ("
+                  << exhaustive_ms / first_exhaustive << "x) refined " << refined_ms << "ms ("
+                  << refined_ms / first_refined << "x) speedup " << exhaustive_ms / refined_ms << "x" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string pattern = argc > 1 ? argv[1] : "input/*";
+
+    std::vector<std::string> files;
+    cv::glob(pattern, files);
+
+    int compared = 0, mismatched = 0;
+    int sparse_compared = 0, sparse_mismatched = 0;
+    int refined_compared = 0, refined_mismatched = 0;
+    std::string timing_file;
+    cv::Mat timing_image;
+    std::vector<double> speedups, kept_ratios;
+    for (const std::string& file : files) {
+        cv::Mat image = cv::imread(file, cv::IMREAD_GRAYSCALE);
+        if (image.empty()) {
+            std::cout << file << ": skipped (unreadable)" << std::endl;
+            continue;
+        }
+        mismatched += compare_engines(file, image, compared);
+        if (std::max(image.rows, image.cols) <= SMALL_IMAGE_MAX_SIDE) {
+            speedups.push_back(compare_legacy(file, image));
+            double kept_ratio = 0.0;
+            ++sparse_compared;
+            if (!compare_sparse(file, image, kept_ratio)) {
+                ++sparse_mismatched;
+            }
+            kept_ratios.push_back(kept_ratio);
+            ++refined_compared;
+            if (!compare_refined(file, image)) {
+                ++refined_mismatched;
+            }
+        } else if (timing_image.empty()) {
+            timing_file = file;
+            timing_image = image;
+        }
+    }
+
+    std::cout << compared << " comparisons, " << mismatched << " mismatched" << std::endl;
+    if (!kept_ratios.empty()) {
+        const auto range = std::minmax_element(kept_ratios.begin(), kept_ratios.end());
+        std::cout << sparse_compared << " sparse comparisons, " << sparse_mismatched << " mismatched; kept "
+                  << *range.first * 100 << "% to " << *range.second * 100 << "% of pixels (" << 1.0 / *range.second
+                  << "x to " << 1.0 / *range.first << "x fewer terms per candidate)" << std::endl;
+    }
+    if (refined_compared > 0) {
+        std::cout << refined_compared << " refined comparisons, " << refined_mismatched << " farther than "
+                  << REFINED_MAX_DISTANCE << "px" << std::endl;
+    }
+    if (!timing_image.empty()) {
+        time_refined(timing_file, timing_image);
+    }
+    if (!speedups.empty()) {
+        std::sort(speedups.begin(), speedups.end());
+#ifdef _OPENMP
+        const char* legacy_build = "legacy built with OpenMP, ";
+#else
+        const char* legacy_build = "legacy built without OpenMP (single-threaded), ";
+#endif
+        std::cout << legacy_build << "median speedup over preversion/grad.cpp on " << LEGACY_ROI_SIDE << "x"
+                  << LEGACY_ROI_SIDE << " ROIs: " << speedups[speedups.size() / 2] << "x (" << speedups.size()
+                  << " images, OpenCV threads " << cv::getNumThreads() << ")" << std::endl;
+    }
+    return (compared > 0 && mismatched == 0 && sparse_mismatched == 0 && refined_mismatched == 0) ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include <opencv2/opencv.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../src/detection.h"
+#include "../src/ellipse_fit.h"
+#include "../src/gradient_intersect.h"
+#include "../src/synthetic_eye.h"
+
+// 用 SyntheticEyeGenerator 在内存中扫描分辨率、瞳孔尺寸、噪声、眼睑遮挡和帧间运动，
+// 对每组参数输出 detect_pupil、rank_pupil_candidates（轮廓筛选 + 椭圆拟合 + 评分）
+// 和 GradientIntersect::locate（在真值眼睛区域上）的平均耗时与中心误差，CSV 写到标准输出。
+// 瞳孔检测的椭圆面积筛选（MIN_ELLIPSE_AREA–MAX_ELLIPSE_AREA）是固定的像素面积，不随分辨率
+// 缩放，因此瞳孔尺寸按绝对像素数扫描，分辨率只改变画面大小（即差分和连通域标记的工作量），
+// 眼睛几何保持 VGA 默认值；in_gate 列标出瞳孔面积是否在筛选范围内，范围外的一组用于确认拒绝。
+// 用法：synthetic_sweep [每组图像对数]
+int main(int argc, char** argv) {
+    const int pairs_per_config = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10;
+
+    const std::vector<cv::Size> resolutions = {{640, 480}, {1280, 720}, {1920, 1080}, {3840, 2160}};
+    // 瞳孔全轴长（像素）：前三组的面积约 640、1130、2200 像素²，位于筛选范围内，最后一组约 4520
+    const std::vector<cv::Size2f> pupil_sizes = {{30.f, 27.f}, {40.f, 36.f}, {56.f, 50.f}, {80.f, 72.f}};
+    const std::vector<double> noise_levels = {0.0, 4.0, 12.0};
+    const std::vector<double> occlusions = {0.0, 0.35};
+    const std::vector<float> motions = {0.f, 3.f}; // 像素
+
+    SyntheticEyeGenerator generator;
+    EllipseFitter fitter;
+    GradientIntersect gradient;
+    cv::Mat light, dark, mask, gray;
+    SyntheticEyeTruth truth;
+    PupilCandidates ranked;
+
+    std::cerr << "pupil ellipse area gate " << MIN_ELLIPSE_AREA << "-" << MAX_ELLIPSE_AREA
+              << " px^2 (fixed, not scaled with resolution)" << std::endl;
+    std::cout << "width,height,pupil_width,pupil_height,in_gate,noise,occlusion,motion,"
+                 "detect_ms,detect_found,detect_error,rank_ms,gradient_ms,gradient_error" << std::endl;
+    for (const cv::Size& resolution : resolutions) {
+        for (const cv::Size2f& pupil_size : pupil_sizes) {
+            const double pupil_area = CV_PI / 4.0 * pupil_size.width * pupil_size.height;
+            const bool in_gate = pupil_area > MIN_ELLIPSE_AREA && pupil_area < MAX_ELLIPSE_AREA;
+            for (double noise : noise_levels) {
+                for (double occlusion : occlusions) {
+                    for (float motion : motions) {
+                        SyntheticEyeParams params;
+                        params.size = resolution;
+                        params.pupil_axes = pupil_size;
+                        params.noise_sigma = noise;
+                        params.eyelid_occlusion = occlusion;
+                        params.motion = cv::Point2f(motion, 0.5f * motion);
+                        params.center_jitter = 0.05f * resolution.height;
+                        generator.set_params(params);
+
+                        double detect_ms = 0.0, rank_ms = 0.0, gradient_ms = 0.0;
+                        double detect_error = 0.0, gradient_error = 0.0;
+                        int found = 0;
+                        for (int i = 0; i < pairs_per_config; ++i) {
+                            generator.generate(light, dark, truth);
+
+                            int64_t start = cv::getTickCount();
+                            const PupilResult pupil = detect_pupil(light, dark);
+                            detect_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+                            if (pupil.found) {
+                                ++found;
+                                detect_error += cv::norm(pupil.center - truth.pupil.center);
+                            }
+
+                            compute_pupil_mask(light, dark, mask);
+                            start = cv::getTickCount();
+                            rank_pupil_candidates(light, dark, mask, fitter, cv::Point2f(-1.f, -1.f), ranked);
+                            rank_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+                            cv::cvtColor(light, gray, cv::COLOR_BGR2GRAY);
+                            start = cv::getTickCount();
+                            const cv::Point center = gradient.locate(gray(truth.eye_roi));
+                            gradient_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+                            gradient_error += cv::norm(cv::Point2f(static_cast<float>(center.x + truth.eye_roi.x),
+                                                                   static_cast<float>(center.y + truth.eye_roi.y)) -
+                                                       truth.pupil.center);
+                        }
+
+                        std::cout << resolution.width << "," << resolution.height << ","
+                                  << params.pupil_axes.width << "," << params.pupil_axes.height << ","
+                                  << in_gate << ","
+                                  << noise << "," << occlusion << "," << cv::norm(params.motion) << ","
+                                  << detect_ms / pairs_per_config << "," << found << ","
+                                  << (found > 0 ? detect_error / found : -1.0) << ","
+                                  << rank_ms / pairs_per_config << ","
+                                  << gradient_ms / pairs_per_config << ","
+                                  << gradient_error / pairs_per_config << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "../src/detection.h"
+#include "../src/eye_tracker.h"
+#include "../src/gradient_intersect.h"
+#include "../src/synthetic_eye.h"
+#include "../src/workspace.h"
+
+// 检查逐帧处理在稳态下是否还有堆分配。
+// 用计数的 cv::MatAllocator 统计 cv::Mat 的数据分配，替换全局 operator new 统计 C++ 堆分配；
+// 在一组合成图像对上循环（眼睛区域尺寸逐帧变化），每项先把所有帧跑两遍预热，再计数。
+// 默认 cv::setNumThreads(1)：多线程时 cv::parallel_for_ 每次调用都会在 OpenCV 线程池内部
+// 分配任务对象，此时只检查 Mat 分配。OpenCV 以 DLL 链接时，替换的 operator new 只能统计
+// 本程序内的分配，OpenCV 内部的 new 不计入（Mat 数据分配仍全部计入）。
+// 级联分类器（ReflectionDetector::process(image)）内部的分配不在检查范围内，光斑检测只测已知眼睛区域的路径。
+// eye_tracker 项在一段首尾相接的眼动序列上跟踪（搜索区域随速度逐帧变化），只检查跟踪状态下的
+// 搜索区域差分和帧配准，跟踪器不加载级联分类器。
+// 用法：workspace_check [每项帧数] [OpenCV 线程数]
+
+static std::atomic<long long> g_heap_allocations(0);
+
+void* operator new(std::size_t size) {
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief 转发给 OpenCV 默认分配器，只统计新分配的数据块（不含使用外部数据的 Mat）。
+ */
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    explicit CountingMatAllocator(cv::MatAllocator* base) : base_(base) {}
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, cv::AccessFlag flags,
+                           cv::UMatUsageFlags usage) const override {
+        if (data == nullptr) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        return base_->allocate(dims, sizes, type, data, step, flags, usage);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usage) const override {
+        return base_->allocate(data, flags, usage);
+    }
+
+    void deallocate(cv::UMatData* data) const override { base_->deallocate(data); }
+
+    mutable std::atomic<long long> allocations{0};
+
+private:
+    cv::MatAllocator* base_;
+};
+
+struct Case {
+    std::string name;
+    std::function<void(int)> run; // 参数为帧序号
+};
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    const int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    const int distinct_pairs = 8;
+    const int gradient_side = 96; // FFT 核频谱按 DFT 尺寸缓存，该项使用固定尺寸的眼睛区域
+
+    cv::setNumThreads(threads);
+    static CountingMatAllocator allocator(cv::Mat::getStdAllocator());
+    cv::Mat::setDefaultAllocator(&allocator);
+
+    // 预先生成全部图像对；眼睛区域随中心抖动改变位置和尺寸
+    SyntheticEyeParams params = synthetic_eye_params(cv::Size(640, 480));
+    params.center_jitter = 40.f;
+    SyntheticEyeGenerator generator(params);
+    std::vector<cv::Mat> lights(distinct_pairs), darks(distinct_pairs), grays(distinct_pairs);
+    std::vector<cv::Rect> eye_rois(distinct_pairs), fixed_rois(distinct_pairs);
+    const cv::Rect image_rect(0, 0, params.size.width, params.size.height);
+    for (int i = 0; i < distinct_pairs; ++i) {
+        SyntheticEyeTruth truth;
+        generator.generate(lights[i], darks[i], truth);
+        cv::cvtColor(lights[i], grays[i], cv::COLOR_BGR2GRAY);
+        const int grow = 4 * i; // 让相邻帧的区域尺寸不同
+        eye_rois[i] = cv::Rect(truth.eye_roi.x - grow, truth.eye_roi.y - grow, truth.eye_roi.width + 2 * grow,
+                               truth.eye_roi.height + 2 * grow) & image_rect;
+        const cv::Point center(cvRound(truth.pupil.center.x), cvRound(truth.pupil.center.y));
+        fixed_rois[i] = cv::Rect(center.x - gradient_side / 2, center.y - gradient_side / 2, gradient_side,
+                                 gradient_side) & image_rect;
+    }
+
+    // 跟踪序列：瞳孔沿圆周运动，首尾相接，循环播放时跟踪器不会丢失目标；
+    // 两次曝光之间的眼动取到下一帧位移的一半，跟踪状态下每帧都做配准
+    const float orbit_radius = 6.f;
+    const cv::Point2f orbit_center(320.f, 240.f);
+    std::vector<cv::Point2f> orbit(distinct_pairs);
+    for (int i = 0; i < distinct_pairs; ++i) {
+        const float angle = static_cast<float>(2.0 * CV_PI * i / distinct_pairs);
+        orbit[i] = orbit_center + orbit_radius * cv::Point2f(std::cos(angle), std::sin(angle));
+    }
+    std::vector<cv::Mat> track_lights(distinct_pairs), track_darks(distinct_pairs);
+    SyntheticEyeGenerator track_generator;
+    for (int i = 0; i < distinct_pairs; ++i) {
+        SyntheticEyeParams track_params = synthetic_eye_params(params.size);
+        track_params.pupil_center = orbit[i];
+        track_params.motion = (orbit[(i + 1) % distinct_pairs] - orbit[i]) * 0.5f;
+        track_params.seed = static_cast<uint64_t>(i + 1);
+        track_generator.set_params(track_params);
+        SyntheticEyeTruth truth;
+        track_generator.generate(track_lights[i], track_darks[i], truth);
+    }
+
+    PupilWorkspace frame_workspace, roi_workspace;
+    frame_workspace.reserve(params.size);
+    ReflectionDetector reflection;
+    GradientIntersect direct, fft, refined;
+    GradientIntersectParams fft_params;
+    fft_params.engine = GRADIENT_ENGINE_FFT;
+    PupilCandidates ranked;
+    EyeTracker tracker(EyeTrackerParams(), "");
+    volatile float sink = 0.f; // 防止结果被优化掉
+
+    const std::vector<Case> cases = {
+        {"detect_pupil", [&](int i) {
+             sink = sink + detect_pupil(lights[i], darks[i], frame_workspace).center.x;
+         }},
+        {"pupil_roi", [&](int i) {
+             roi_workspace.begin_frame();
+             cv::Mat mask;
+             if (compute_pupil_mask(lights[i](eye_rois[i]), darks[i](eye_rois[i]), roi_workspace, mask)) {
+                 rank_pupil_candidates(lights[i](eye_rois[i]), darks[i](eye_rois[i]), mask, roi_workspace,
+                                       cv::Point2f(-1.f, -1.f), ranked);
+                 sink = sink + ranked.count;
+             }
+         }},
+        {"reflection_roi", [&](int i) {
+             sink = sink + reflection.process(lights[i], eye_rois[i]).center.x;
+         }},
+        {"gradient_direct", [&](int i) {
+             sink = sink + direct.locate(grays[i](eye_rois[i])).x;
+         }},
+        {"gradient_fft", [&](int i) {
+             sink = sink + fft.locate(grays[i](fixed_rois[i]), fft_params).x;
+         }},
+        {"gradient_refined", [&](int i) {
+             sink = sink + refined.locateRefined(grays[i](eye_rois[i])).x;
+         }},
+        {"eye_tracker", [&](int i) {
+             sink = sink + tracker.process(track_lights[i], track_darks[i]).pupil.center.x;
+         }},
+    };
+
+    std::cout << frames << " frames per case, " << distinct_pairs << " distinct pairs, OpenCV threads "
+              << cv::getNumThreads() << "\n"
+              << std::left << std::setw(18) << "case" << std::right << std::setw(10) << "ms/frame"
+              << std::setw(12) << "mat allocs" << std::setw(13) << "heap allocs" << "\n";
+    bool passed = true;
+    for (const Case& test : cases) {
+        // 预热：每帧跑两遍，arena 在第一遍后按最大区域扩容，容器容量也达到峰值
+        for (int i = 0; i < 2 * distinct_pairs; ++i) {
+            test.run(i % distinct_pairs);
+        }
+
+        const long long mat_before = allocator.allocations.load();
+        const long long heap_before = g_heap_allocations.load();
+        const int64_t start = cv::getTickCount();
+        for (int i = 0; i < frames; ++i) {
+            test.run(i % distinct_pairs);
+        }
+        const double ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency() / frames;
+        const long long mat_allocs = allocator.allocations.load() - mat_before;
+        const long long heap_allocs = g_heap_allocations.load() - heap_before;
+
+        const bool ok = mat_allocs == 0 && (heap_allocs == 0 || cv::getNumThreads() > 1);
+        passed = passed && ok;
+        std::cout << std::left << std::setw(18) << test.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << ms << std::setw(12) << mat_allocs << std::setw(13) << heap_allocs
+                  << (ok ? "" : "  FAILED") << "\n";
+    }
+    if (cv::getNumThreads() > 1) {
+        std::cout << "heap allocations not checked with more than one OpenCV thread" << "\n";
+    }
+    std::cout << (passed ? "steady state is allocation-free" : "steady state allocates") << std::endl;
+
+    cv::Mat::setDefaultAllocator(nullptr);
+    return passed ? 0 : 1;
+}